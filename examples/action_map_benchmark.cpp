@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <glfwpp/action_map.h>
+#include <glfwpp/glfwpp.h>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+// Compares glfw::ActionMap with looking up the actions of every key event in
+// an std::unordered_map, and checks that rebinding does not allocate
+
+static std::size_t allocationCount = 0;
+
+void* operator new(std::size_t size_)
+{
+    ++allocationCount;
+    if(void* memory = std::malloc(size_ ? size_ : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* memory_) noexcept
+{
+    std::free(memory_);
+}
+
+void operator delete(void* memory_, std::size_t) noexcept
+{
+    std::free(memory_);
+}
+
+constexpr std::size_t actionCount = 512;
+constexpr std::size_t bindingCount = 1024;
+constexpr int frames = 20'000;
+constexpr int eventsPerFrame = 16;
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point start_, double count_)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start_).count() / count_;
+}
+
+int main()
+{
+    const glfw::KeyCode keys[] = {
+            glfw::KeyCode::A, glfw::KeyCode::D, glfw::KeyCode::S, glfw::KeyCode::W, glfw::KeyCode::Space, glfw::KeyCode::Q, glfw::KeyCode::E, glfw::KeyCode::R,
+            glfw::KeyCode::F, glfw::KeyCode::Tab, glfw::KeyCode::One, glfw::KeyCode::Two, glfw::KeyCode::Three, glfw::KeyCode::Up, glfw::KeyCode::Down, glfw::KeyCode::Escape};
+    const glfw::ModifierKeyBit mods[] = {{}, glfw::ModifierKeyBit::Control, glfw::ModifierKeyBit::Shift, glfw::ModifierKeyBit::Alt};
+
+    glfw::ActionMap map{actionCount, bindingCount};
+    std::unordered_map<int, std::vector<std::pair<std::size_t, int>>> lookup;
+    std::vector<glfw::ActionMap::BindingId> ids;
+    for(std::size_t i = 0; i < bindingCount; ++i)
+    {
+        const std::size_t action = i % actionCount;
+        glfw::ActionBinding binding;
+        switch(i % 8)
+        {
+            case 6:
+                binding = glfw::ActionBinding::mouseButton(static_cast<glfw::MouseButton>(i % 3));
+                break;
+            case 7:
+                binding = glfw::ActionBinding::gamepadButton(static_cast<glfw::GamepadButton>(i % 15));
+                break;
+            default:
+                binding = glfw::ActionBinding::key(keys[i % 16], mods[i / 16 % 4]);
+                lookup[binding.code].emplace_back(action, static_cast<int>(binding.mods));
+        }
+        ids.push_back(map.bind(action, binding));
+    }
+
+    glfw::GamepadState gamepad{};
+    std::vector<unsigned char> mapDown(actionCount);
+    std::size_t checksum = 0;
+
+    auto start = Clock::now();
+    for(int frame = 0; frame < frames; ++frame)
+    {
+        for(int i = 0; i < eventsPerFrame; ++i)
+        {
+            const int key = keys[(frame + i) % 16];
+            const int state = (frame + i) % 2 ? GLFW_RELEASE : GLFW_PRESS;
+            const int modBits = static_cast<int>(mods[i % 4]);
+            for(const auto& [action, bindingMods] : lookup[key])
+            {
+                mapDown[action] = state == GLFW_PRESS && (modBits & bindingMods) == bindingMods;
+            }
+        }
+        for(unsigned char down : mapDown)
+        {
+            checksum += down;
+        }
+    }
+    const double unorderedNs = elapsedNs(start, frames);
+
+    start = Clock::now();
+    for(int frame = 0; frame < frames; ++frame)
+    {
+        for(int i = 0; i < eventsPerFrame; ++i)
+        {
+            const glfw::KeyState state = (frame + i) % 2 ? glfw::KeyState::Release : glfw::KeyState::Press;
+            map.handleKey(keys[(frame + i) % 16], 0, state, mods[i % 4]);
+        }
+        gamepad.buttons[frame % 15] = !gamepad.buttons[frame % 15];
+        map.update(&gamepad);
+        for(std::size_t action = 0; action < actionCount; action += 64)
+        {
+            checksum += map.isDown(action) + map.wentDown(action);
+        }
+    }
+    const double actionMapNs = elapsedNs(start, frames);
+
+    const std::size_t allocationsBefore = allocationCount;
+    constexpr int rebinds = 10'000;
+    start = Clock::now();
+    for(int i = 0; i < rebinds; ++i)
+    {
+        const glfw::ActionMap::BindingId id = ids[static_cast<std::size_t>(i) % ids.size()];
+        map.rebind(id, glfw::ActionBinding::key(keys[i % 16], mods[i % 4]));
+    }
+    const double rebindNs = elapsedNs(start, rebinds);
+
+    std::printf("%zu actions, %zu bindings, %d key events per frame\n", actionCount, bindingCount, eventsPerFrame);
+    std::printf("std::unordered_map lookups:    %8.0f ns/frame\n", unorderedNs);
+    std::printf("glfw::ActionMap (incl. update): %8.0f ns/frame\n", actionMapNs);
+    std::printf("glfw::ActionMap::rebind:        %8.0f ns, %zu allocations\n", rebindNs, allocationCount - allocationsBefore);
+    std::printf("(checksum %zu)\n", checksum);
+}
@@ -0,0 +1,43 @@
+#include <cstdio>
+#include <glfwpp/coroutine.h>
+
+// Scripted interaction written as a coroutine instead of a state machine
+glfw::Task tutorial(glfw::Window& window_)
+{
+    window_.setTitle("Resize the window");
+    auto [window, width, height] = co_await window_.framebufferSizeEvent;
+    std::printf("Resized to %dx%d\n", width, height);
+
+    window_.setTitle("Press space within 5 seconds");
+    auto pressed = co_await glfw::nextEvent(
+            window_.keyEvent,
+            [](glfw::Window&, glfw::KeyCode key_, int, glfw::KeyState state_, glfw::ModifierKeyBit) {
+                return key_ == glfw::KeyCode::Space && state_ == glfw::KeyState::Press;
+            },
+            5.0);
+    std::printf(pressed ? "Space pressed\n" : "Too slow\n");
+
+    for(int i = 3; i > 0; --i)
+    {
+        std::printf("Closing in %d\n", i);
+        co_await glfw::sleepFor(1.0);
+    }
+    window_.setShouldClose(true);
+}
+
+int main()
+{
+    [[maybe_unused]] glfw::GlfwLibrary library = glfw::init();
+
+    glfw::WindowHints hints;
+    hints.clientApi = glfw::ClientApi::None;
+    hints.apply();
+    glfw::Window wnd(800, 600, "GLFWPP coroutines example");
+
+    glfw::Task task = tutorial(wnd);
+    while(!wnd.shouldClose())
+    {
+        glfw::waitEventsScheduled();
+    }
+    task.rethrowIfFailed();
+}
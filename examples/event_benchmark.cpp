@@ -0,0 +1,107 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <glfwpp/glfwpp.h>
+#include <new>
+#include <vector>
+
+static std::atomic<std::size_t> allocationCount{0};
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if(void* ptr = std::malloc(size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// Large enough to not fit into the small buffer of std::function
+struct Handler
+{
+    double* sink;
+    double scale;
+    double bias;
+
+    void operator()(int key, double value) const
+    {
+        *sink += key * scale + value + bias;
+    }
+};
+
+constexpr int iterations = 10'000'000;
+
+template<typename DispatchT>
+void report(const char* name, int subscribers, std::size_t setupAllocations, DispatchT&& dispatch)
+{
+    const std::size_t before = allocationCount;
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; ++i)
+    {
+        dispatch(i & 0xFF, 0.5);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const std::size_t dispatchAllocations = allocationCount - before;
+
+    const double nsPerDispatch = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::printf("%-24s %2d subscribers: %6.2f ns/dispatch %6.2f ns/subscriber, %zu allocations during setup, %zu during dispatch\n",
+            name,
+            subscribers,
+            nsPerDispatch,
+            nsPerDispatch / subscribers,
+            setupAllocations,
+            dispatchAllocations);
+}
+
+int main()
+{
+    double sink = 0;
+
+    for(int subscribers : {1, 2, 4, 8})
+    {
+        // The std::function way: one callback per event, several listeners chained by hand
+        {
+            const std::size_t before = allocationCount;
+            std::vector<std::function<void(int, double)>> listeners;
+            for(int i = 0; i < subscribers; ++i)
+            {
+                listeners.emplace_back(Handler{&sink, 1.0 + i, 0.25});
+            }
+            std::function<void(int, double)> callback = [&listeners](int key, double value) {
+                for(auto&& listener : listeners)
+                {
+                    listener(key, value);
+                }
+            };
+            report("std::function chain", subscribers, allocationCount - before, callback);
+        }
+
+        // glfw::Event with inline subscribers
+        {
+            const std::size_t before = allocationCount;
+            glfw::Event<int, double> event;
+            std::vector<glfw::Subscription> subscriptions(subscribers);
+            const std::size_t vectorAllocations = allocationCount - before;
+            for(int i = 0; i < subscribers; ++i)
+            {
+                subscriptions[i] = event.subscribe(Handler{&sink, 1.0 + i, 0.25});
+            }
+            report("glfw::Event::subscribe", subscribers, allocationCount - before - vectorAllocations, event);
+        }
+    }
+
+    std::printf("(checksum %f)\n", sink);
+}
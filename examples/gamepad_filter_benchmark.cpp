@@ -0,0 +1,48 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <glfwpp/gamepad_filter.h>
+#include <glfwpp/glfwpp.h>
+
+// Filters 16 synthetic gamepads per frame with the SIMD and the scalar kernel
+
+constexpr int frames = 1'000'000;
+
+int main()
+{
+    [[maybe_unused]] auto GLFW = glfw::init();
+
+    glfw::GamepadFilterConfig config;
+    config.responseCurve = 0.5f;
+    config.smoothing = 0.2f;
+
+    static glfw::GamepadBatch raw{};
+    raw.presentMask = 0xFFFF;
+
+    for(bool simd : {true, false})
+    {
+        glfw::GamepadFilter filter{config};
+        filter.setSimdEnabled(simd);
+        if(filter.getSimdEnabled() != simd)
+        {
+            std::printf("SIMD kernel not available\n");
+            continue;
+        }
+
+        double checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            for(std::size_t axis = 0; axis < glfw::GamepadBatch::axisCount; ++axis)
+            {
+                raw.axes[axis][frame % glfw::GamepadBatch::gamepadCount] = std::sin(static_cast<float>(frame + axis));
+            }
+            checksum += filter.filter(raw).axes[frame % glfw::GamepadBatch::axisCount][0];
+        }
+        const auto end = std::chrono::steady_clock::now();
+        std::printf("%-6s 16 gamepads: %7.1f ns/frame (checksum %f)\n",
+                simd ? "SIMD" : "scalar",
+                std::chrono::duration<double, std::nano>(end - start).count() / frames,
+                checksum);
+    }
+}
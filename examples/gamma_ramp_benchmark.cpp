@@ -0,0 +1,43 @@
+#include <chrono>
+#include <cstdio>
+#include <glfwpp/gamma_ramp.h>
+#include <glfwpp/glfwpp.h>
+
+// Builds gamma ramps of common sizes with the SIMD and the scalar kernel
+
+constexpr int ramps = 20'000;
+
+int main()
+{
+    [[maybe_unused]] auto GLFW = glfw::init();
+
+    for(std::size_t size : {256, 1024, 4096})
+    {
+        for(bool simd : {true, false})
+        {
+            glfw::GammaRampBuilder builder{size};
+            builder.setSimdEnabled(simd);
+            if(builder.getSimdEnabled() != simd)
+            {
+                std::printf("SIMD kernel not available\n");
+                continue;
+            }
+
+            unsigned checksum = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for(int i = 0; i < ramps; ++i)
+            {
+                glfw::GammaCurve curve;
+                curve.gamma = 1.0f + static_cast<float>(i % 100) / 100;
+                curve.temperature = 6500.0f - static_cast<float>(i % 3000);
+                checksum += builder.build(curve).green[size / 2];
+            }
+            const auto end = std::chrono::steady_clock::now();
+            std::printf("%-6s %4zu entries: %8.1f ns/ramp (checksum %u)\n",
+                    simd ? "SIMD" : "scalar",
+                    size,
+                    std::chrono::duration<double, std::nano>(end - start).count() / ramps,
+                    checksum);
+        }
+    }
+}
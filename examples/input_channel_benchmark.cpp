@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <glfwpp/glfwpp.h>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t eventCount = 20'000'000;
+
+int main()
+{
+    glfw::InputChannel channel{4096};
+    const Clock::time_point origin = Clock::now();
+
+    std::vector<double> latencies;
+    latencies.reserve(eventCount / 1024 + 1);
+
+    // Simulation thread
+    std::thread consumer{[&] {
+        std::size_t received = 0;
+        while(received < eventCount)
+        {
+            received += channel.drain([&](const glfw::WindowEvent& event) {
+                if(event.type == glfw::WindowEventType::CursorPos && (static_cast<std::size_t>(event.cursorPos.y) & 1023) == 0)
+                {
+                    const double now = std::chrono::duration<double, std::nano>(Clock::now() - origin).count();
+                    latencies.push_back(now - event.cursorPos.x);
+                }
+            });
+        }
+    }};
+
+    // Main thread, standing in for the GLFW callbacks
+    const Clock::time_point start = Clock::now();
+    for(std::size_t i = 0; i < eventCount; ++i)
+    {
+        glfw::WindowEvent event{nullptr, glfw::WindowEventType::CursorPos, 0, {}};
+        event.cursorPos = {std::chrono::duration<double, std::nano>(Clock::now() - origin).count(), static_cast<double>(i)};
+        while(!channel.tryPush(event))
+        {
+            // Back-pressure: a real producer would rather drop or coalesce
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    std::printf("%zu events in %.3f s: %.1f million events/s\n", eventCount, seconds, eventCount / seconds / 1e6);
+    std::printf("latency p50 %.0f ns, p99 %.0f ns, max %.0f ns\n",
+            latencies[latencies.size() / 2],
+            latencies[latencies.size() * 99 / 100],
+            latencies.back());
+    std::printf("overflows %llu, high-water mark %zu of %zu\n",
+            static_cast<unsigned long long>(channel.getOverflowCount()),
+            channel.getHighWaterMark(),
+            channel.capacity());
+}
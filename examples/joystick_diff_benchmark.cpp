@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <glfwpp/glfwpp.h>
+#include <glfwpp/joystick_diff.h>
+
+// Diffs snapshots of 16 synthetic joysticks per frame with glfw::JoystickDiff
+// and with a plain loop over every input of every joystick
+
+constexpr int frames = 1'000'000;
+constexpr float threshold = 0.01f;
+
+static glfw::JoystickSnapshot snapshot{};
+
+static void changeSnapshot(int frame_)
+{
+    const std::size_t jid = frame_ % glfw::JoystickSnapshot::joystickCount;
+    snapshot.axes[frame_ % 6][jid] = std::sin(static_cast<float>(frame_));
+    snapshot.buttons[jid] ^= std::uint64_t{1} << (frame_ % 16);
+}
+
+int main()
+{
+    [[maybe_unused]] auto GLFW = glfw::init();
+
+    snapshot.presentMask = 0xFFFF;
+    for(std::size_t jid = 0; jid < glfw::JoystickSnapshot::joystickCount; ++jid)
+    {
+        snapshot.axisCount[jid] = 6;
+        snapshot.buttonCount[jid] = 16;
+    }
+    const glfw::JoystickSnapshot initial = snapshot;
+
+    {
+        glfw::JoystickDiff diff{threshold, false};
+        std::size_t events = 0;
+        const auto buttons = diff.buttonEvent.subscribe([&](glfw::Joystick, int, bool) {
+            ++events;
+        });
+        const auto axes = diff.axisEvent.subscribe([&](glfw::Joystick, int, float) {
+            ++events;
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            changeSnapshot(frame);
+            diff.process(snapshot);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        std::printf("JoystickDiff: %7.1f ns/frame (%zu events)\n",
+                std::chrono::duration<double, std::nano>(end - start).count() / frames,
+                events);
+    }
+
+    snapshot = initial;
+    {
+        static glfw::JoystickSnapshot previous{};
+        std::size_t events = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            changeSnapshot(frame);
+            for(std::size_t jid = 0; jid < glfw::JoystickSnapshot::joystickCount; ++jid)
+            {
+                for(std::size_t button = 0; button < snapshot.buttonCount[jid]; ++button)
+                {
+                    const bool pressed = snapshot.buttons[jid] >> button & 1;
+                    if(pressed != (previous.buttons[jid] >> button & 1))
+                    {
+                        previous.buttons[jid] ^= std::uint64_t{1} << button;
+                        ++events;
+                    }
+                }
+                for(std::size_t axis = 0; axis < snapshot.axisCount[jid]; ++axis)
+                {
+                    if(std::fabs(snapshot.axes[axis][jid] - previous.axes[axis][jid]) > threshold)
+                    {
+                        previous.axes[axis][jid] = snapshot.axes[axis][jid];
+                        ++events;
+                    }
+                }
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        std::printf("Per input:    %7.1f ns/frame (%zu events)\n",
+                std::chrono::duration<double, std::nano>(end - start).count() / frames,
+                events);
+    }
+}
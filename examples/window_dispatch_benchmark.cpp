@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cstdio>
+#include <glfwpp/glfwpp.h>
+
+// Calls the GLFW callbacks installed on the windows directly, the same way
+// GLFW does when it processes OS events, to measure the dispatch cost alone
+
+struct Sink
+{
+    double cursor = 0;
+    int keys = 0;
+};
+
+class StaticWindow : public glfw::BasicWindow<StaticWindow>
+{
+public:
+    Sink* sink = nullptr;
+
+    using BasicWindow::BasicWindow;
+
+    void onKey(glfw::KeyCode key_, int, glfw::KeyState state_, glfw::ModifierKeyBit)
+    {
+        sink->keys += static_cast<int>(key_) + static_cast<int>(state_);
+    }
+
+    void onCursorPos(double x_, double y_)
+    {
+        sink->cursor += x_ + y_;
+    }
+};
+
+constexpr int iterations = 10'000'000;
+
+template<typename CallbackT, typename... Args>
+double measure(CallbackT callback_, GLFWwindow* handle_, Args... args_)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; ++i)
+    {
+        callback_(handle_, args_...);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+template<typename SetterT>
+auto getInstalledCallback(GLFWwindow* handle_, SetterT setter_)
+{
+    auto callback = setter_(handle_, nullptr);
+    setter_(handle_, callback);
+    return callback;
+}
+
+int main()
+{
+    [[maybe_unused]] auto GLFW = glfw::init();
+
+    glfw::WindowHints hints;
+    hints.visible = false;
+    hints.clientApi = glfw::ClientApi::None;
+    hints.apply();
+
+    Sink sink;
+
+    glfw::Window window{64, 64, "glfw::Window"};
+    window.keyEvent.setCallback([&sink](glfw::Window&, glfw::KeyCode key_, int, glfw::KeyState state_, glfw::ModifierKeyBit) {
+        sink.keys += static_cast<int>(key_) + static_cast<int>(state_);
+    });
+    window.cursorPosEvent.setCallback([&sink](glfw::Window&, double x_, double y_) {
+        sink.cursor += x_ + y_;
+    });
+
+    StaticWindow staticWindow{64, 64, "glfw::BasicWindow"};
+    staticWindow.sink = &sink;
+
+    for(glfw::Window* target : {&window, static_cast<glfw::Window*>(&staticWindow)})
+    {
+        GLFWwindow* handle = *target;
+        const double keyNs = measure(getInstalledCallback(handle, glfwSetKeyCallback), handle, GLFW_KEY_A, 38, GLFW_PRESS, 0);
+        const double cursorNs = measure(getInstalledCallback(handle, glfwSetCursorPosCallback), handle, 1.0, 2.0);
+        std::printf("%-20s key: %6.2f ns/event, cursor position: %6.2f ns/event\n",
+                target == &window ? "glfw::Window" : "glfw::BasicWindow",
+                keyNs,
+                cursorNs);
+    }
+
+    std::printf("Events without a handler have a GLFW callback installed: glfw::Window %s, glfw::BasicWindow %s\n",
+            getInstalledCallback(window, glfwSetScrollCallback) ? "yes" : "no",
+            getInstalledCallback(staticWindow, glfwSetScrollCallback) ? "yes" : "no");
+
+    std::printf("(checksum %f %d)\n", sink.cursor, sink.keys);
+}
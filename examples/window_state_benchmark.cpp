@@ -0,0 +1,58 @@
+#include <chrono>
+#include <cstdio>
+#include <glfwpp/glfwpp.h>
+
+// Compares the window geometry and attribute getters with and without
+// Window::setStateCachingEnabled. Without the cache every getter is a
+// round trip to the display server on X11 (run it e.g. under Xvfb).
+
+constexpr int iterations = 100'000;
+
+struct Sink
+{
+    double sum = 0;
+    int flags = 0;
+};
+
+double measure(const glfw::Window& window_, Sink& sink_)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < iterations; ++i)
+    {
+        const auto [xPos, yPos] = window_.getPos();
+        const auto [width, height] = window_.getSize();
+        const auto [framebufferWidth, framebufferHeight] = window_.getFramebufferSize();
+        const auto [cursorX, cursorY] = window_.getCursorPos();
+        sink_.sum += xPos + yPos + width + height + framebufferWidth + framebufferHeight + cursorX + cursorY;
+        sink_.flags += window_.getAttribFocused() + window_.getAttribIconified() + window_.getAttribMaximized() + window_.getAttribVisible();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int main()
+{
+    [[maybe_unused]] auto GLFW = glfw::init();
+
+    glfw::WindowHints hints;
+    hints.clientApi = glfw::ClientApi::None;
+    hints.apply();
+
+    glfw::Window window{640, 480, "Window state"};
+    glfw::pollEvents();
+
+    Sink sink;
+    const double liveUs = measure(window, sink);
+
+    window.setStateCachingEnabled(true);
+    const double cachedUs = measure(window, sink);
+
+    const auto [cachedWidth, cachedHeight] = window.getSize();
+    window.refreshCachedState();
+    const auto [liveWidth, liveHeight] = window.getSize();
+
+    std::printf("live:   %8.3f us/frame\n", liveUs);
+    std::printf("cached: %8.3f us/frame (%.1fx)\n", cachedUs, liveUs / cachedUs);
+    std::printf("cached size %dx%d, live size %dx%d\n", cachedWidth, cachedHeight, liveWidth, liveHeight);
+    std::printf("(checksum %f %d)\n", sink.sum, sink.flags);
+}
@@ -0,0 +1,532 @@
+#ifndef GLFWPP_ACTION_MAP_H
+#define GLFWPP_ACTION_MAP_H
+
+#include "error.h"
+#include "event.h"
+#include "joystick.h"
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace glfw
+{
+    enum class ActionSource : std::uint8_t
+    {
+        Key,
+        Scancode,
+        MouseButton,
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        GamepadButton,
+        GamepadAxis
+#endif
+    };
+
+    // One input that triggers an action. Key, scancode and mouse button
+    // bindings are only active while all of `mods` are held as well.
+    struct ActionBinding
+    {
+        ActionSource source;
+        int code;
+        ModifierKeyBit mods;
+        // Axis bindings are active while the axis is at or beyond the
+        // threshold. A negative threshold selects the negative direction.
+        float threshold;
+
+        [[nodiscard]] static ActionBinding key(KeyCode key_, ModifierKeyBit mods_ = {}) noexcept
+        {
+            return {ActionSource::Key, key_, mods_, 0};
+        }
+        [[nodiscard]] static ActionBinding scancode(int scancode_, ModifierKeyBit mods_ = {}) noexcept
+        {
+            return {ActionSource::Scancode, scancode_, mods_, 0};
+        }
+        [[nodiscard]] static ActionBinding mouseButton(MouseButton button_, ModifierKeyBit mods_ = {}) noexcept
+        {
+            return {ActionSource::MouseButton, static_cast<int>(button_), mods_, 0};
+        }
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        [[nodiscard]] static ActionBinding gamepadButton(GamepadButton button_) noexcept
+        {
+            return {ActionSource::GamepadButton, static_cast<int>(button_), {}, 0};
+        }
+        [[nodiscard]] static ActionBinding gamepadAxis(GamepadAxis axis_, float threshold_ = 0.5f) noexcept
+        {
+            return {ActionSource::GamepadAxis, static_cast<int>(axis_), {}, threshold_};
+        }
+#endif
+    };
+
+    // Maps keys, scancodes, mouse buttons and gamepad inputs to actions
+    // identified by the indices 0 to actionCount - 1. The bindings are
+    // compiled into flat arrays grouped by action, plus an offset table
+    // indexed by key code, scancode and mouse button that lists the bindings
+    // of every input, so an event only touches its own bindings. update()
+    // evaluates all actions in one pass over the compiled bindings. All
+    // storage is allocated by the constructor; binding, rebinding and
+    // unbinding recompile the tables in place.
+    class ActionMap
+    {
+    public:
+        using BindingId = std::size_t;
+
+        static constexpr std::size_t keyCount = GLFW_KEY_LAST + 1;
+        static constexpr std::size_t mouseButtonCount = GLFW_MOUSE_BUTTON_LAST + 1;
+
+    private:
+        static constexpr std::size_t _unused = static_cast<std::size_t>(-1);
+
+        std::size_t _actionCount;
+        std::size_t _scancodeCount;
+
+        // Bindings as set by the user, indexed by BindingId
+        std::vector<ActionBinding> _bindings;
+        std::vector<std::size_t> _bindingActions;
+        std::vector<BindingId> _freeIds;
+
+        // Key, scancode and mouse button bindings grouped by action. The
+        // bindings of action a are [_actionOffsets[a], _actionOffsets[a + 1]).
+        std::vector<std::size_t> _actionOffsets;
+        std::vector<std::uint8_t> _digitalHeld;
+        std::vector<int> _digitalMods;
+
+        // Indices into the digital bindings per input: key codes first, then
+        // scancodes, then mouse buttons
+        std::vector<std::size_t> _inputOffsets;
+        std::vector<std::size_t> _inputSlots;
+
+        // Gamepad buttons followed by gamepad axes
+        std::size_t _gamepadCount;
+        std::size_t _gamepadAxisBegin;
+        std::vector<std::size_t> _gamepadActions;
+        std::vector<int> _gamepadCodes;
+        std::vector<float> _gamepadThresholds;
+
+        // Raw input state, needed to restore the held flags after a recompile
+        std::vector<std::uint8_t> _keyDown;
+        std::vector<std::uint8_t> _scancodeDown;
+        std::uint8_t _mouseButtonDown[mouseButtonCount];
+        int _mods;  // From the held modifier keys, see _updateMods
+
+        std::vector<float> _values;
+        std::vector<std::uint64_t> _down;
+        std::vector<std::uint64_t> _previousDown;
+
+        Subscription _keySubscription;
+        Subscription _mouseButtonSubscription;
+
+        [[nodiscard]] bool _isValidCode(const ActionBinding& binding_) const noexcept
+        {
+            switch(binding_.source)
+            {
+                case ActionSource::Key:
+                    return binding_.code >= 0 && binding_.code < static_cast<int>(keyCount);
+                case ActionSource::Scancode:
+                    return binding_.code >= 0 && binding_.code < static_cast<int>(_scancodeCount);
+                case ActionSource::MouseButton:
+                    return binding_.code >= 0 && binding_.code < static_cast<int>(mouseButtonCount);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case ActionSource::GamepadButton:
+                    return binding_.code >= 0 && binding_.code <= GLFW_GAMEPAD_BUTTON_LAST;
+                case ActionSource::GamepadAxis:
+                    return binding_.code >= 0 && binding_.code <= GLFW_GAMEPAD_AXIS_LAST;
+#endif
+            }
+            return false;
+        }
+
+        // Index of the input of a key, scancode or mouse button binding in _inputOffsets
+        [[nodiscard]] std::size_t _inputOf(const ActionBinding& binding_) const noexcept
+        {
+            const std::size_t code = static_cast<std::size_t>(binding_.code);
+            switch(binding_.source)
+            {
+                case ActionSource::Key:
+                    return code;
+                case ActionSource::Scancode:
+                    return keyCount + code;
+                default:
+                    return keyCount + _scancodeCount + code;
+            }
+        }
+
+        [[nodiscard]] static bool _isDigital(const ActionBinding& binding_) noexcept
+        {
+            return binding_.source == ActionSource::Key || binding_.source == ActionSource::Scancode || binding_.source == ActionSource::MouseButton;
+        }
+
+        [[nodiscard]] bool _isHeld(const ActionBinding& binding_) const noexcept
+        {
+            switch(binding_.source)
+            {
+                case ActionSource::Key:
+                    return _keyDown[binding_.code];
+                case ActionSource::Scancode:
+                    return _scancodeDown[binding_.code];
+                case ActionSource::MouseButton:
+                    return _mouseButtonDown[binding_.code];
+                default:
+                    return false;
+            }
+        }
+
+        // Turns counts stored at offsets_[k + 1] into the start of every group k
+        static void _countsToStarts(std::vector<std::size_t>& offsets_) noexcept
+        {
+            for(std::size_t k = 1; k < offsets_.size(); ++k)
+            {
+                offsets_[k] += offsets_[k - 1];
+            }
+        }
+
+        // After filling advanced every start to the end of its group, moves
+        // the starts back into place
+        static void _endsToStarts(std::vector<std::size_t>& offsets_) noexcept
+        {
+            for(std::size_t k = offsets_.size() - 1; k > 0; --k)
+            {
+                offsets_[k] = offsets_[k - 1];
+            }
+            offsets_[0] = 0;
+        }
+
+        // Two counting sorts over the bindings: by action for evaluation and
+        // by input for the event lookups. Needs no storage of its own.
+        void _compile() noexcept
+        {
+            std::fill(_actionOffsets.begin(), _actionOffsets.end(), 0);
+            std::fill(_inputOffsets.begin(), _inputOffsets.end(), 0);
+            for(BindingId id = 0; id < _bindings.size(); ++id)
+            {
+                if(_bindingActions[id] != _unused && _isDigital(_bindings[id]))
+                {
+                    ++_actionOffsets[_bindingActions[id] + 1];
+                    ++_inputOffsets[_inputOf(_bindings[id]) + 1];
+                }
+            }
+            _countsToStarts(_actionOffsets);
+            _countsToStarts(_inputOffsets);
+
+            for(BindingId id = 0; id < _bindings.size(); ++id)
+            {
+                if(_bindingActions[id] != _unused && _isDigital(_bindings[id]))
+                {
+                    const ActionBinding& binding = _bindings[id];
+                    const std::size_t slot = _actionOffsets[_bindingActions[id]]++;
+                    _digitalHeld[slot] = _isHeld(binding);
+                    _digitalMods[slot] = static_cast<int>(binding.mods);
+                    _inputSlots[_inputOffsets[_inputOf(binding)]++] = slot;
+                }
+            }
+            _endsToStarts(_actionOffsets);
+            _endsToStarts(_inputOffsets);
+
+            _gamepadCount = 0;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            for(ActionSource source : {ActionSource::GamepadButton, ActionSource::GamepadAxis})
+            {
+                if(source == ActionSource::GamepadAxis)
+                {
+                    _gamepadAxisBegin = _gamepadCount;
+                }
+                for(BindingId id = 0; id < _bindings.size(); ++id)
+                {
+                    if(_bindingActions[id] != _unused && _bindings[id].source == source)
+                    {
+                        _gamepadActions[_gamepadCount] = _bindingActions[id];
+                        _gamepadCodes[_gamepadCount] = _bindings[id].code;
+                        _gamepadThresholds[_gamepadCount] = _bindings[id].threshold;
+                        ++_gamepadCount;
+                    }
+                }
+            }
+#endif
+            std::fill(_values.begin(), _values.end(), 0.0f);
+        }
+
+        void _assign(BindingId id_, std::size_t action_, const ActionBinding& binding_)
+        {
+            if(action_ >= _actionCount || !_isValidCode(binding_))
+            {
+                throw Error("Invalid action binding");
+            }
+            _bindings[id_] = binding_;
+            _bindingActions[id_] = action_;
+            _compile();
+        }
+
+        // The mods of an event can be stale: on X11 a modifier key's own
+        // event carries the state from before it. So Shift, Control, Alt and
+        // Super come from the held modifier keys and only the lock states
+        // from the event.
+        void _updateMods(ModifierKeyBit mods_) noexcept
+        {
+            int mods = 0;
+            if(_keyDown[GLFW_KEY_LEFT_SHIFT] || _keyDown[GLFW_KEY_RIGHT_SHIFT])
+            {
+                mods |= GLFW_MOD_SHIFT;
+            }
+            if(_keyDown[GLFW_KEY_LEFT_CONTROL] || _keyDown[GLFW_KEY_RIGHT_CONTROL])
+            {
+                mods |= GLFW_MOD_CONTROL;
+            }
+            if(_keyDown[GLFW_KEY_LEFT_ALT] || _keyDown[GLFW_KEY_RIGHT_ALT])
+            {
+                mods |= GLFW_MOD_ALT;
+            }
+            if(_keyDown[GLFW_KEY_LEFT_SUPER] || _keyDown[GLFW_KEY_RIGHT_SUPER])
+            {
+                mods |= GLFW_MOD_SUPER;
+            }
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            mods |= static_cast<int>(mods_) & (GLFW_MOD_CAPS_LOCK | GLFW_MOD_NUM_LOCK);
+#else
+            (void)mods_;
+#endif
+            _mods = mods;
+        }
+
+        void _setHeld(std::size_t input_, bool held_) noexcept
+        {
+            for(std::size_t i = _inputOffsets[input_]; i < _inputOffsets[input_ + 1]; ++i)
+            {
+                _digitalHeld[_inputSlots[i]] = held_;
+            }
+        }
+
+    public:
+        // `scancodeCount_` bounds the scancodes that can be bound; events with
+        // larger scancodes only match key code bindings
+        ActionMap(std::size_t actionCount_, std::size_t bindingCapacity_, std::size_t scancodeCount_ = 512) :
+            _actionCount{actionCount_},
+            _scancodeCount{scancodeCount_},
+            _bindings(bindingCapacity_),
+            _bindingActions(bindingCapacity_, _unused),
+            _freeIds{},
+            _actionOffsets(actionCount_ + 1),
+            _digitalHeld(bindingCapacity_),
+            _digitalMods(bindingCapacity_),
+            _inputOffsets(keyCount + scancodeCount_ + mouseButtonCount + 1),
+            _inputSlots(bindingCapacity_),
+            _gamepadCount{0},
+            _gamepadAxisBegin{0},
+            _gamepadActions(bindingCapacity_),
+            _gamepadCodes(bindingCapacity_),
+            _gamepadThresholds(bindingCapacity_),
+            _keyDown(keyCount),
+            _scancodeDown(scancodeCount_),
+            _mouseButtonDown{},
+            _mods{0},
+            _values(actionCount_),
+            _down((actionCount_ + 63) / 64),
+            _previousDown((actionCount_ + 63) / 64)
+        {
+            _freeIds.reserve(bindingCapacity_);
+            for(BindingId id = bindingCapacity_; id > 0; --id)
+            {
+                _freeIds.push_back(id - 1);
+            }
+            _compile();
+        }
+
+        ActionMap(const ActionMap&) = delete;
+        ActionMap& operator=(const ActionMap&) = delete;
+
+        [[nodiscard]] std::size_t getActionCount() const noexcept
+        {
+            return _actionCount;
+        }
+
+        [[nodiscard]] std::size_t getBindingCount() const noexcept
+        {
+            return _bindings.size() - _freeIds.size();
+        }
+
+        BindingId bind(std::size_t action_, const ActionBinding& binding_)
+        {
+            if(_freeIds.empty())
+            {
+                throw Error("Action binding capacity exceeded");
+            }
+            const BindingId id = _freeIds.back();
+            _assign(id, action_, binding_);
+            _freeIds.pop_back();
+            return id;
+        }
+
+        void rebind(BindingId id_, std::size_t action_, const ActionBinding& binding_)
+        {
+            if(id_ >= _bindings.size() || _bindingActions[id_] == _unused)
+            {
+                throw Error("Invalid action binding id");
+            }
+            _assign(id_, action_, binding_);
+        }
+
+        void rebind(BindingId id_, const ActionBinding& binding_)
+        {
+            if(id_ >= _bindings.size() || _bindingActions[id_] == _unused)
+            {
+                throw Error("Invalid action binding id");
+            }
+            _assign(id_, _bindingActions[id_], binding_);
+        }
+
+        void unbind(BindingId id_)
+        {
+            if(id_ < _bindings.size() && _bindingActions[id_] != _unused)
+            {
+                _bindingActions[id_] = _unused;
+                _freeIds.push_back(id_);
+                _compile();
+            }
+        }
+
+        [[nodiscard]] const ActionBinding& getBinding(BindingId id_) const
+        {
+            return _bindings[id_];
+        }
+
+        // Feeds the key and mouse button events of `window_` into the map
+        // until detach() or destruction
+        void attach(Window& window_)
+        {
+            _keySubscription = window_.keyEvent.subscribe([this](Window&, KeyCode key_, int scancode_, KeyState state_, ModifierKeyBit mods_) {
+                handleKey(key_, scancode_, state_, mods_);
+            });
+            _mouseButtonSubscription = window_.mouseButtonEvent.subscribe([this](Window&, MouseButton button_, MouseButtonState state_, ModifierKeyBit mods_) {
+                handleMouseButton(button_, state_, mods_);
+            });
+        }
+
+        void detach() noexcept
+        {
+            _keySubscription = {};
+            _mouseButtonSubscription = {};
+        }
+
+        void handleKey(KeyCode key_, int scancode_, KeyState state_, ModifierKeyBit mods_) noexcept
+        {
+            if(state_ == KeyState::Repeat)
+            {
+                _updateMods(mods_);
+                return;
+            }
+
+            const bool held = state_ == KeyState::Press;
+            const int key = key_;
+            if(key >= 0 && key < static_cast<int>(keyCount))
+            {
+                _keyDown[key] = held;
+                _setHeld(static_cast<std::size_t>(key), held);
+            }
+            if(scancode_ >= 0 && scancode_ < static_cast<int>(_scancodeCount))
+            {
+                _scancodeDown[scancode_] = held;
+                _setHeld(keyCount + static_cast<std::size_t>(scancode_), held);
+            }
+            _updateMods(mods_);
+        }
+
+        void handleMouseButton(MouseButton button_, MouseButtonState state_, ModifierKeyBit mods_) noexcept
+        {
+            _updateMods(mods_);
+            const int button = static_cast<int>(button_);
+            if(button >= 0 && button < static_cast<int>(mouseButtonCount))
+            {
+                const bool held = state_ == MouseButtonState::Press;
+                _mouseButtonDown[button] = held;
+                _setHeld(keyCount + _scancodeCount + static_cast<std::size_t>(button), held);
+            }
+        }
+
+        // Evaluates all actions, once per frame after polling. `gamepad_` may
+        // be nullptr when no gamepad is used.
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        void update(const GamepadState* gamepad_ = nullptr) noexcept
+#else
+        void update() noexcept
+#endif
+        {
+            _previousDown.swap(_down);
+
+            for(std::size_t word = 0; word < _down.size(); ++word)
+            {
+                std::uint64_t bits = 0;
+                const std::size_t first = word * 64;
+                const std::size_t last = std::min(first + 64, _actionCount);
+                for(std::size_t action = first; action < last; ++action)
+                {
+                    std::uint64_t active = 0;
+                    for(std::size_t i = _actionOffsets[action]; i < _actionOffsets[action + 1]; ++i)
+                    {
+                        active |= _digitalHeld[i] & ((_mods & _digitalMods[i]) == _digitalMods[i]);
+                    }
+                    bits |= active << (action - first);
+                }
+                _down[word] = bits;
+            }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            if(_gamepadAxisBegin != _gamepadCount)
+            {
+                std::fill(_values.begin(), _values.end(), 0.0f);
+            }
+            if(gamepad_)
+            {
+                for(std::size_t i = 0; i < _gamepadAxisBegin; ++i)
+                {
+                    const std::uint64_t active = gamepad_->buttons[_gamepadCodes[i]];
+                    const std::size_t action = _gamepadActions[i];
+                    _down[action / 64] |= active << (action % 64);
+                }
+                for(std::size_t i = _gamepadAxisBegin; i < _gamepadCount; ++i)
+                {
+                    const float threshold = _gamepadThresholds[i];
+                    const float axis = gamepad_->axes[_gamepadCodes[i]];
+                    const float magnitude = threshold < 0 ? -axis : axis;
+                    const std::size_t action = _gamepadActions[i];
+                    if(magnitude >= std::abs(threshold))
+                    {
+                        _values[action] = std::max(_values[action], magnitude);
+                        _down[action / 64] |= std::uint64_t{1} << (action % 64);
+                    }
+                }
+            }
+#endif
+        }
+
+        [[nodiscard]] bool isDown(std::size_t action_) const noexcept
+        {
+            return _down[action_ / 64] >> (action_ % 64) & 1;
+        }
+
+        // The action became active at the last update()
+        [[nodiscard]] bool wentDown(std::size_t action_) const noexcept
+        {
+            return (_down[action_ / 64] & ~_previousDown[action_ / 64]) >> (action_ % 64) & 1;
+        }
+
+        // The action became inactive at the last update()
+        [[nodiscard]] bool wentUp(std::size_t action_) const noexcept
+        {
+            return (~_down[action_ / 64] & _previousDown[action_ / 64]) >> (action_ % 64) & 1;
+        }
+
+        // The largest axis magnitude for actions activated by an axis binding,
+        // 1 for other active actions and 0 for inactive ones
+        [[nodiscard]] float getValue(std::size_t action_) const noexcept
+        {
+            if(!isDown(action_))
+            {
+                return 0;
+            }
+            return _values[action_] > 0 ? _values[action_] : 1.0f;
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_ACTION_MAP_H
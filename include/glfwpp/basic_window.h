@@ -0,0 +1,282 @@
+#ifndef GLFWPP_BASIC_WINDOW_H
+#define GLFWPP_BASIC_WINDOW_H
+
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <type_traits>
+#include <utility>
+
+namespace glfw
+{
+    namespace detail
+    {
+        template<typename, template<typename...> class, typename...>
+        struct IsDetected : std::false_type
+        {
+        };
+        template<template<typename...> class OpT, typename... Args>
+        struct IsDetected<std::void_t<OpT<Args...>>, OpT, Args...> : std::true_type
+        {
+        };
+        template<template<typename...> class OpT, typename... Args>
+        constexpr bool isDetected = IsDetected<void, OpT, Args...>::value;
+
+        template<typename T>
+        using OnPosT = decltype(std::declval<T&>().onPos(0, 0));
+        template<typename T>
+        using OnSizeT = decltype(std::declval<T&>().onSize(0, 0));
+        template<typename T>
+        using OnCloseT = decltype(std::declval<T&>().onClose());
+        template<typename T>
+        using OnRefreshT = decltype(std::declval<T&>().onRefresh());
+        template<typename T>
+        using OnFocusT = decltype(std::declval<T&>().onFocus(false));
+        template<typename T>
+        using OnIconifyT = decltype(std::declval<T&>().onIconify(false));
+        template<typename T>
+        using OnMaximizeT = decltype(std::declval<T&>().onMaximize(false));
+        template<typename T>
+        using OnFramebufferSizeT = decltype(std::declval<T&>().onFramebufferSize(0, 0));
+        template<typename T>
+        using OnContentScaleT = decltype(std::declval<T&>().onContentScale(0.0f, 0.0f));
+        template<typename T>
+        using OnKeyT = decltype(std::declval<T&>().onKey(std::declval<KeyCode>(), 0, std::declval<KeyState>(), std::declval<ModifierKeyBit>()));
+        template<typename T>
+        using OnCharT = decltype(std::declval<T&>().onChar(0u));
+        template<typename T>
+        using OnMouseButtonT = decltype(std::declval<T&>().onMouseButton(std::declval<MouseButton>(), std::declval<MouseButtonState>(), std::declval<ModifierKeyBit>()));
+        template<typename T>
+        using OnCursorPosT = decltype(std::declval<T&>().onCursorPos(0.0, 0.0));
+        template<typename T>
+        using OnCursorEnterT = decltype(std::declval<T&>().onCursorEnter(false));
+        template<typename T>
+        using OnScrollT = decltype(std::declval<T&>().onScroll(0.0, 0.0));
+        template<typename T>
+        using OnDropT = decltype(std::declval<T&>().onDrop(0, std::declval<const char**>()));
+    }  // namespace detail
+
+    // Window whose events are handled by member functions of `HandlersT`,
+    // which must derive from BasicWindow<HandlersT>:
+    //
+    //     class GameWindow : public glfw::BasicWindow<GameWindow>
+    //     {
+    //     public:
+    //         using BasicWindow::BasicWindow;
+    //         void onKey(glfw::KeyCode, int, glfw::KeyState, glfw::ModifierKeyBit);
+    //         void onCursorPos(double, double);
+    //     };
+    //
+    // The GLFW callbacks call the handlers directly, so they can be inlined.
+    // Only events with a handler get a GLFW callback; the Event members,
+    // anyEvent, event queues and coalescing of Window are bypassed, and
+    // enabling an option that relies on the callbacks of Window (event
+    // queues, deferred properties, input state, motion accumulators and
+    // state caching) throws. Handlers must be accessible to BasicWindow
+    // (public or befriending it). Their names and parameters are those of
+    // the Window events without the Window& parameter, except for
+    // onDrop(int count, const char** paths).
+    template<typename HandlersT>
+    class BasicWindow : public Window
+    {
+    private:
+        // Called on entry of every callback
+        static HandlersT& _getHandlers(GLFWwindow* handle_)
+        {
+            detail::stampEvent();
+            return static_cast<HandlersT&>(_getWrapperFromHandle(handle_));
+        }
+
+        static void _posCallback(GLFWwindow* window_, int xPos_, int yPos_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Pos));
+            _getHandlers(window_).onPos(xPos_, yPos_);
+        }
+        static void _sizeCallback(GLFWwindow* window_, int width_, int height_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Size));
+            _getHandlers(window_).onSize(width_, height_);
+        }
+        static void _closeCallback(GLFWwindow* window_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Close));
+            _getHandlers(window_).onClose();
+        }
+        static void _refreshCallback(GLFWwindow* window_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Refresh));
+            _getHandlers(window_).onRefresh();
+        }
+        static void _focusCallback(GLFWwindow* window_, int value_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Focus));
+            _getHandlers(window_).onFocus(value_);
+        }
+        static void _iconifyCallback(GLFWwindow* window_, int value_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Iconify));
+            _getHandlers(window_).onIconify(value_);
+        }
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        static void _maximizeCallback(GLFWwindow* window_, int value_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Maximize));
+            _getHandlers(window_).onMaximize(value_);
+        }
+#endif
+        static void _framebufferSizeCallback(GLFWwindow* window_, int width_, int height_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::FramebufferSize));
+            _getHandlers(window_).onFramebufferSize(width_, height_);
+        }
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        static void _contentScaleCallback(GLFWwindow* window_, float xScale_, float yScale_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::ContentScale));
+            _getHandlers(window_).onContentScale(xScale_, yScale_);
+        }
+#endif
+        static void _keyCallback(GLFWwindow* window_, int key_, int scanCode_, int state_, int mods_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Key));
+            _getHandlers(window_).onKey(static_cast<decltype(KeyCode::Unknown)>(key_), scanCode_, static_cast<KeyState>(state_), static_cast<ModifierKeyBit>(mods_));
+        }
+        static void _charCallback(GLFWwindow* window_, unsigned int codePoint_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Char));
+            _getHandlers(window_).onChar(codePoint_);
+        }
+        static void _mouseButtonCallback(GLFWwindow* window_, int button_, int state_, int mods_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::MouseButton));
+            _getHandlers(window_).onMouseButton(static_cast<MouseButton>(button_), static_cast<MouseButtonState>(state_), static_cast<ModifierKeyBit>(mods_));
+        }
+        static void _cursorPosCallback(GLFWwindow* window_, double xPos_, double yPos_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::CursorPos));
+            _getHandlers(window_).onCursorPos(xPos_, yPos_);
+        }
+        static void _cursorEnterCallback(GLFWwindow* window_, int value_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::CursorEnter));
+            _getHandlers(window_).onCursorEnter(value_);
+        }
+        static void _scrollCallback(GLFWwindow* window_, double xOffset_, double yOffset_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Scroll));
+            _getHandlers(window_).onScroll(xOffset_, yOffset_);
+        }
+        static void _dropCallback(GLFWwindow* window_, int count_, const char** pPaths_)
+        {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Drop));
+            _getHandlers(window_).onDrop(count_, pPaths_);
+        }
+
+        void _installCallbacks()
+        {
+            static_assert(std::is_base_of_v<BasicWindow, HandlersT>, "HandlersT must derive from BasicWindow<HandlersT>");
+
+            GLFWwindow* handle = *this;
+            if(!handle)
+            {
+                return;
+            }
+            _setEventHooks(nullptr);
+            _subclassCallbacks = true;
+
+            if constexpr(detail::isDetected<detail::OnPosT, HandlersT>)
+                glfwSetWindowPosCallback(handle, _posCallback);
+            else
+                glfwSetWindowPosCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnSizeT, HandlersT>)
+                glfwSetWindowSizeCallback(handle, _sizeCallback);
+            else
+                glfwSetWindowSizeCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnCloseT, HandlersT>)
+                glfwSetWindowCloseCallback(handle, _closeCallback);
+            else
+                glfwSetWindowCloseCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnRefreshT, HandlersT>)
+                glfwSetWindowRefreshCallback(handle, _refreshCallback);
+            else
+                glfwSetWindowRefreshCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnFocusT, HandlersT>)
+                glfwSetWindowFocusCallback(handle, _focusCallback);
+            else
+                glfwSetWindowFocusCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnIconifyT, HandlersT>)
+                glfwSetWindowIconifyCallback(handle, _iconifyCallback);
+            else
+                glfwSetWindowIconifyCallback(handle, nullptr);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            if constexpr(detail::isDetected<detail::OnMaximizeT, HandlersT>)
+                glfwSetWindowMaximizeCallback(handle, _maximizeCallback);
+            else
+                glfwSetWindowMaximizeCallback(handle, nullptr);
+#endif
+            if constexpr(detail::isDetected<detail::OnFramebufferSizeT, HandlersT>)
+                glfwSetFramebufferSizeCallback(handle, _framebufferSizeCallback);
+            else
+                glfwSetFramebufferSizeCallback(handle, nullptr);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            if constexpr(detail::isDetected<detail::OnContentScaleT, HandlersT>)
+                glfwSetWindowContentScaleCallback(handle, _contentScaleCallback);
+            else
+                glfwSetWindowContentScaleCallback(handle, nullptr);
+#endif
+
+            if constexpr(detail::isDetected<detail::OnKeyT, HandlersT>)
+                glfwSetKeyCallback(handle, _keyCallback);
+            else
+                glfwSetKeyCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnCharT, HandlersT>)
+                glfwSetCharCallback(handle, _charCallback);
+            else
+                glfwSetCharCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnMouseButtonT, HandlersT>)
+                glfwSetMouseButtonCallback(handle, _mouseButtonCallback);
+            else
+                glfwSetMouseButtonCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnCursorPosT, HandlersT>)
+                glfwSetCursorPosCallback(handle, _cursorPosCallback);
+            else
+                glfwSetCursorPosCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnCursorEnterT, HandlersT>)
+                glfwSetCursorEnterCallback(handle, _cursorEnterCallback);
+            else
+                glfwSetCursorEnterCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnScrollT, HandlersT>)
+                glfwSetScrollCallback(handle, _scrollCallback);
+            else
+                glfwSetScrollCallback(handle, nullptr);
+            if constexpr(detail::isDetected<detail::OnDropT, HandlersT>)
+                glfwSetDropCallback(handle, _dropCallback);
+            else
+                glfwSetDropCallback(handle, nullptr);
+        }
+
+    public:
+        explicit BasicWindow() noexcept = default;
+
+        //Takes ownership
+        explicit BasicWindow(GLFWwindow* handle_) :
+            Window{handle_}
+        {
+            _installCallbacks();
+        }
+
+        BasicWindow(int width_,
+                int height_,
+                const char* title_,
+                const Monitor* monitor_ = nullptr,
+                const Window* share_ = nullptr) :
+            Window{width_, height_, title_, monitor_, share_}
+        {
+            _installCallbacks();
+        }
+
+        BasicWindow(BasicWindow&&) noexcept = default;
+        BasicWindow& operator=(BasicWindow&&) noexcept = default;
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_BASIC_WINDOW_H
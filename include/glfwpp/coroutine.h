@@ -0,0 +1,573 @@
+#ifndef GLFWPP_COROUTINE_H
+#define GLFWPP_COROUTINE_H
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+    #error "glfwpp/coroutine.h requires C++20 coroutine support"
+#endif
+
+#include "event.h"
+#include "glfwpp.h"
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace glfw
+{
+    namespace detail
+    {
+        // Recycles coroutine frames by size class, so starting a Task only
+        // touches the heap until the pool has warmed up
+        class CoroutineFramePool
+        {
+        private:
+            static constexpr std::size_t _granularity = 64;
+            static constexpr std::size_t _classCount = 32;
+
+            struct FreeBlock
+            {
+                FreeBlock* next;
+            };
+
+            FreeBlock* _freeLists[_classCount] = {};
+
+            [[nodiscard]] static std::size_t _classOf(std::size_t size_) noexcept
+            {
+                return (size_ + _granularity - 1) / _granularity - 1;
+            }
+
+        public:
+            CoroutineFramePool() noexcept = default;
+
+            CoroutineFramePool(const CoroutineFramePool&) = delete;
+            CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+            ~CoroutineFramePool() noexcept
+            {
+                for(FreeBlock*& list : _freeLists)
+                {
+                    while(list)
+                    {
+                        ::operator delete(std::exchange(list, list->next));
+                    }
+                }
+            }
+
+            [[nodiscard]] void* allocate(std::size_t size_)
+            {
+                const std::size_t sizeClass = _classOf(size_);
+                if(sizeClass >= _classCount)
+                {
+                    return ::operator new(size_);
+                }
+                if(FreeBlock* block = _freeLists[sizeClass])
+                {
+                    _freeLists[sizeClass] = block->next;
+                    return block;
+                }
+                return ::operator new((sizeClass + 1) * _granularity);
+            }
+
+            void deallocate(void* ptr_, std::size_t size_) noexcept
+            {
+                const std::size_t sizeClass = _classOf(size_);
+                if(sizeClass >= _classCount)
+                {
+                    ::operator delete(ptr_);
+                    return;
+                }
+                _freeLists[sizeClass] = new(ptr_) FreeBlock{_freeLists[sizeClass]};
+            }
+        };
+
+        inline CoroutineFramePool coroutineFramePool;
+
+        // A suspended coroutine waiting for an event, a frame or a deadline
+        struct CoroutineWaiter
+        {
+            std::coroutine_handle<> handle;
+            Subscription subscription;
+            bool pending = false;
+        };
+
+        // Resumes suspended coroutines on the main thread at the end of
+        // pollEvents and waitEvents. Waiters are kept in reusable vectors so
+        // awaiting does not allocate once they have grown.
+        class CoroutineScheduler
+        {
+        private:
+            struct Timer
+            {
+                double deadline;
+                CoroutineWaiter* waiter;
+            };
+
+            std::vector<CoroutineWaiter*> _ready;
+            std::vector<CoroutineWaiter*> _nextFrame;
+            std::vector<CoroutineWaiter*> _resuming;
+            std::vector<Timer> _timers;
+            bool _running = false;
+
+            static void _onPoll(void* scheduler_)
+            {
+                static_cast<CoroutineScheduler*>(scheduler_)->run();
+            }
+
+            void _register()
+            {
+                static Hook<> hook{postPollHooks, &CoroutineScheduler::_onPoll, this};
+                (void)hook;
+            }
+
+            void _removeTimer(CoroutineWaiter* waiter_) noexcept
+            {
+                _timers.erase(std::remove_if(_timers.begin(), _timers.end(), [waiter_](const Timer& timer_) {
+                    return timer_.waiter == waiter_;
+                }),
+                        _timers.end());
+            }
+
+        public:
+            void scheduleReady(CoroutineWaiter& waiter_)
+            {
+                _removeTimer(&waiter_);
+                _ready.push_back(&waiter_);
+            }
+
+            void scheduleNextFrame(CoroutineWaiter& waiter_)
+            {
+                _register();
+                waiter_.pending = true;
+                _nextFrame.push_back(&waiter_);
+            }
+
+            void scheduleTimer(CoroutineWaiter& waiter_, double deadline_)
+            {
+                _register();
+                waiter_.pending = true;
+                _timers.push_back({deadline_, &waiter_});
+            }
+
+            void watch(CoroutineWaiter& waiter_)
+            {
+                _register();
+                waiter_.pending = true;
+            }
+
+            void cancel(CoroutineWaiter& waiter_) noexcept
+            {
+                waiter_.subscription.reset();
+                for(std::vector<CoroutineWaiter*>* list : {&_ready, &_nextFrame, &_resuming})
+                {
+                    std::replace(list->begin(), list->end(), &waiter_, static_cast<CoroutineWaiter*>(nullptr));
+                }
+                _removeTimer(&waiter_);
+                waiter_.pending = false;
+            }
+
+            [[nodiscard]] bool hasRunnable() const noexcept
+            {
+                return !_ready.empty() || !_nextFrame.empty();
+            }
+
+            [[nodiscard]] std::optional<double> getEarliestDeadline() const noexcept
+            {
+                if(_timers.empty())
+                {
+                    return std::nullopt;
+                }
+                return std::min_element(_timers.begin(), _timers.end(), [](const Timer& a_, const Timer& b_) {
+                    return a_.deadline < b_.deadline;
+                })->deadline;
+            }
+
+            // Resumes the coroutines whose event fired, then those waiting for
+            // the frame, then those whose deadline has passed
+            void run()
+            {
+                if(_running)
+                {
+                    return;
+                }
+                _running = true;
+
+                _resuming.clear();
+                _resuming.insert(_resuming.end(), _ready.begin(), _ready.end());
+                _resuming.insert(_resuming.end(), _nextFrame.begin(), _nextFrame.end());
+                _ready.clear();
+                _nextFrame.clear();
+
+                if(!_timers.empty())
+                {
+                    const double now = getTime();
+                    for(std::size_t i = 0; i < _timers.size();)
+                    {
+                        if(_timers[i].deadline <= now)
+                        {
+                            CoroutineWaiter* waiter = _timers[i].waiter;
+                            waiter->subscription.reset();
+                            _resuming.push_back(waiter);
+                            _timers[i] = _timers.back();
+                            _timers.pop_back();
+                        }
+                        else
+                        {
+                            ++i;
+                        }
+                    }
+                }
+
+                for(std::size_t i = 0; i < _resuming.size(); ++i)
+                {
+                    if(CoroutineWaiter* waiter = std::exchange(_resuming[i], nullptr))
+                    {
+                        waiter->pending = false;
+                        waiter->handle.resume();
+                    }
+                }
+                _resuming.clear();
+                _running = false;
+            }
+        };
+
+        inline CoroutineScheduler coroutineScheduler;
+
+        // References are stored as pointers, everything else by value
+        template<typename T>
+        using AwaitStoredT = std::conditional_t<std::is_reference_v<T>,
+                std::reference_wrapper<std::remove_reference_t<T>>,
+                std::decay_t<T>>;
+
+        struct AcceptAll
+        {
+            template<typename... Args>
+            constexpr bool operator()(const Args&...) const noexcept
+            {
+                return true;
+            }
+        };
+
+        // Waits for the next invocation of an Event accepted by `PredicateT`.
+        // The handler stored in the event only captures the awaiter.
+        template<bool TimedV, typename PredicateT, typename... Args>
+        class EventAwaiter : private CoroutineWaiter
+        {
+        private:
+            Event<Args...>& _event;
+            PredicateT _predicate;
+            double _timeout;
+            std::optional<std::tuple<AwaitStoredT<Args>...>> _result;
+
+        public:
+            EventAwaiter(Event<Args...>& event_, PredicateT predicate_, double timeout_) :
+                _event{event_},
+                _predicate{std::move(predicate_)},
+                _timeout{timeout_}
+            {
+            }
+
+            EventAwaiter(const EventAwaiter&) = delete;
+            EventAwaiter& operator=(const EventAwaiter&) = delete;
+
+            ~EventAwaiter() noexcept
+            {
+                if(pending)
+                {
+                    coroutineScheduler.cancel(*this);
+                }
+            }
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle_)
+            {
+                handle = handle_;
+                subscription = _event.subscribe([this](EventParamT<Args>... args_) {
+                    if(!_result && _predicate(args_...))
+                    {
+                        _result.emplace(args_...);
+                        subscription.reset();
+                        coroutineScheduler.scheduleReady(*this);
+                    }
+                });
+                if constexpr(TimedV)
+                {
+                    coroutineScheduler.scheduleTimer(*this, getTime() + _timeout);
+                }
+                else
+                {
+                    coroutineScheduler.watch(*this);
+                }
+            }
+
+            auto await_resume()
+            {
+                if constexpr(TimedV)
+                {
+                    return _result ? std::optional<std::tuple<Args...>>{std::make_from_tuple<std::tuple<Args...>>(*_result)} : std::nullopt;
+                }
+                else
+                {
+                    return std::make_from_tuple<std::tuple<Args...>>(*_result);
+                }
+            }
+        };
+
+        class FrameAwaiter : private CoroutineWaiter
+        {
+        public:
+            FrameAwaiter() noexcept = default;
+
+            FrameAwaiter(const FrameAwaiter&) = delete;
+            FrameAwaiter& operator=(const FrameAwaiter&) = delete;
+
+            ~FrameAwaiter() noexcept
+            {
+                if(pending)
+                {
+                    coroutineScheduler.cancel(*this);
+                }
+            }
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle_)
+            {
+                handle = handle_;
+                coroutineScheduler.scheduleNextFrame(*this);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        class SleepAwaiter : private CoroutineWaiter
+        {
+        private:
+            double _duration;
+
+        public:
+            explicit SleepAwaiter(double duration_) noexcept :
+                _duration{duration_}
+            {
+            }
+
+            SleepAwaiter(const SleepAwaiter&) = delete;
+            SleepAwaiter& operator=(const SleepAwaiter&) = delete;
+
+            ~SleepAwaiter() noexcept
+            {
+                if(pending)
+                {
+                    coroutineScheduler.cancel(*this);
+                }
+            }
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle_)
+            {
+                handle = handle_;
+                coroutineScheduler.scheduleTimer(*this, getTime() + _duration);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+    }  // namespace detail
+
+    // Coroutine started eagerly by calling it and owned by the returned Task.
+    // Destroying the Task destroys the coroutine, cancelling whatever it
+    // awaits. Coroutine frames are allocated from a pool.
+    class Task
+    {
+    public:
+        class promise_type
+        {
+        private:
+            friend class Task;
+            std::exception_ptr _exception;
+
+        public:
+            Task get_return_object() noexcept
+            {
+                return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+            }
+
+            std::suspend_never initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            std::suspend_always final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            void return_void() const noexcept
+            {
+            }
+
+            void unhandled_exception() noexcept
+            {
+                _exception = std::current_exception();
+            }
+
+            static void* operator new(std::size_t size_)
+            {
+                return detail::coroutineFramePool.allocate(size_);
+            }
+
+            static void operator delete(void* ptr_, std::size_t size_) noexcept
+            {
+                detail::coroutineFramePool.deallocate(ptr_, size_);
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> _handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle_) noexcept :
+            _handle{handle_}
+        {
+        }
+
+    public:
+        Task() noexcept = default;
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other_) noexcept :
+            _handle{std::exchange(other_._handle, nullptr)}
+        {
+        }
+
+        Task& operator=(Task&& other_) noexcept
+        {
+            if(this != &other_)
+            {
+                reset();
+                _handle = std::exchange(other_._handle, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task() noexcept
+        {
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            if(_handle)
+            {
+                std::exchange(_handle, nullptr).destroy();
+            }
+        }
+
+        [[nodiscard]] bool isDone() const noexcept
+        {
+            return !_handle || _handle.done();
+        }
+
+        // Rethrows the exception that ended the coroutine, if any
+        void rethrowIfFailed() const
+        {
+            if(_handle && _handle.done() && _handle.promise()._exception)
+            {
+                std::rethrow_exception(_handle.promise()._exception);
+            }
+        }
+    };
+
+    // `co_await event` suspends until the event is invoked and returns its
+    // arguments as a tuple. The coroutine is resumed at the end of the
+    // current pollEvents/waitEvents, so pointer arguments such as dropped
+    // paths are no longer valid by then.
+    template<typename... Args>
+    [[nodiscard]] detail::EventAwaiter<false, detail::AcceptAll, Args...> operator co_await(Event<Args...>& event_)
+    {
+        return {event_, {}, 0.0};
+    }
+
+    // Suspends until `event_` is invoked with arguments accepted by `predicate_`
+    template<typename PredicateT, typename... Args>
+    [[nodiscard]] detail::EventAwaiter<false, PredicateT, Args...> nextEvent(Event<Args...>& event_, PredicateT predicate_)
+    {
+        return {event_, std::move(predicate_), 0.0};
+    }
+
+    // Suspends until `event_` is invoked or `timeout_` seconds have passed.
+    // Returns std::nullopt on timeout.
+    template<typename... Args>
+    [[nodiscard]] detail::EventAwaiter<true, detail::AcceptAll, Args...> nextEvent(Event<Args...>& event_, double timeout_)
+    {
+        return {event_, {}, timeout_};
+    }
+
+    template<typename PredicateT, typename... Args>
+    [[nodiscard]] detail::EventAwaiter<true, PredicateT, Args...> nextEvent(Event<Args...>& event_, PredicateT predicate_, double timeout_)
+    {
+        return {event_, std::move(predicate_), timeout_};
+    }
+
+    // Suspends until the end of the next pollEvents/waitEvents
+    [[nodiscard]] inline detail::FrameAwaiter nextFrame() noexcept
+    {
+        return {};
+    }
+
+    // Suspends for at least `duration_` seconds of getTime()
+    [[nodiscard]] inline detail::SleepAwaiter sleepFor(double duration_) noexcept
+    {
+        return detail::SleepAwaiter{duration_};
+    }
+
+    // Processes events like waitEvents, but returns in time to resume the
+    // earliest sleeping coroutine and does not block while coroutines wait
+    // for the next frame
+    inline void waitEventsScheduled()
+    {
+        if(detail::coroutineScheduler.hasRunnable())
+        {
+            pollEvents();
+        }
+        else if(const std::optional<double> deadline = detail::coroutineScheduler.getEarliestDeadline())
+        {
+            const double timeout = *deadline - getTime();
+            if(timeout > 0)
+            {
+                waitEvents(timeout);
+            }
+            else
+            {
+                pollEvents();
+            }
+        }
+        else
+        {
+            waitEvents();
+        }
+    }
+}  // namespace glfw
+
+#endif  //GLFWPP_COROUTINE_H
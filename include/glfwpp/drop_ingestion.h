@@ -0,0 +1,399 @@
+#ifndef GLFWPP_DROP_INGESTION_H
+#define GLFWPP_DROP_INGESTION_H
+
+#include "error.h"
+#include "event.h"
+#include "mapped_file.h"
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace glfw
+{
+    struct DropProgress
+    {
+        std::uint64_t dropId;
+        std::size_t fileIndex;
+        std::size_t fileCount;
+        const char* path;
+        std::uint64_t bytesProcessed;
+        std::uint64_t fileSize;
+    };
+
+    struct DropCompletion
+    {
+        std::uint64_t dropId;
+        std::size_t fileIndex;
+        std::size_t fileCount;
+        const char* path;
+        bool succeeded;
+        const char* error;  // nullptr if succeeded
+    };
+
+    // Part of a dropped file handed to the processor on a worker thread. The
+    // data is only valid during the call.
+    struct DropChunk
+    {
+        const char* path;
+        const unsigned char* data;
+        std::size_t size;
+        std::uint64_t offset;
+        std::uint64_t fileSize;
+    };
+
+    struct DropIngestionOptions
+    {
+        std::size_t workerCount = 2;
+        std::size_t chunkSize = 4 * 1024 * 1024;
+        // Files that cannot be mapped are read in chunks instead
+        bool memoryMap = true;
+    };
+
+    // Processes dropped files on a pool of worker threads. The paths of a drop
+    // are copied into storage owned by the ingestor, every file is memory
+    // mapped (or read) and passed to the processor in chunks on a worker, and
+    // progressEvent and completionEvent are invoked on the main thread at the
+    // end of pollEvents/waitEvents. Workers wake up the event loop with
+    // postEmptyEvent when they have something to report.
+    class DropIngestor
+    {
+    public:
+        // Called on a worker thread for every chunk of a file. Returning false
+        // stops processing the file, which then completes successfully.
+        using ProcessorT = std::function<bool(const DropChunk&)>;
+
+    private:
+        struct Batch
+        {
+            std::uint64_t id;
+            std::vector<char> storage;
+            std::vector<const char*> paths;
+        };
+
+        struct Job
+        {
+            std::shared_ptr<const Batch> batch;
+            std::size_t index;
+        };
+
+        struct Notification
+        {
+            std::shared_ptr<const Batch> batch;
+            std::size_t index;
+            bool completed;
+            std::uint64_t bytesProcessed;
+            std::uint64_t fileSize;
+            std::string error;
+        };
+
+        ProcessorT _processor;
+        DropIngestionOptions _options;
+        std::uint64_t _nextDropId;
+        std::size_t _pendingFiles;
+
+        std::mutex _jobMutex;
+        std::condition_variable _jobAvailable;
+        std::deque<Job> _jobs;
+        bool _stopping;
+
+        std::mutex _notificationMutex;
+        std::vector<Notification> _notifications;
+        std::vector<Notification> _delivering;
+
+        detail::Hook<> _deliveryHook;
+        std::vector<std::thread> _workers;
+
+        static void _onPoll(void* ingestor_)
+        {
+            static_cast<DropIngestor*>(ingestor_)->deliver();
+        }
+
+        void _notify(Notification&& notification_)
+        {
+            bool wasEmpty;
+            {
+                std::lock_guard lock{_notificationMutex};
+                wasEmpty = _notifications.empty();
+
+                // Only the latest progress of a file is worth delivering
+                if(!wasEmpty && !notification_.completed)
+                {
+                    Notification& last = _notifications.back();
+                    if(!last.completed && last.batch == notification_.batch && last.index == notification_.index)
+                    {
+                        last.bytesProcessed = notification_.bytesProcessed;
+                        return;
+                    }
+                }
+                _notifications.push_back(std::move(notification_));
+            }
+            if(wasEmpty)
+            {
+                glfwPostEmptyEvent();
+            }
+        }
+
+        // Returns false if the processor asked to stop
+        bool _feed(const Job& job_, const unsigned char* data_, std::size_t size_, std::uint64_t offset_, std::uint64_t fileSize_)
+        {
+            const bool proceed = _processor(DropChunk{job_.batch->paths[job_.index], data_, size_, offset_, fileSize_});
+            _notify({job_.batch, job_.index, false, offset_ + size_, fileSize_, {}});
+            return proceed;
+        }
+
+        void _map(const Job& job_, const detail::MappedFile& file_)
+        {
+            const std::size_t chunkSize = _options.chunkSize ? _options.chunkSize : file_.size();
+            std::size_t offset = 0;
+            do
+            {
+                const std::size_t size = std::min(chunkSize, file_.size() - offset);
+                if(!_feed(job_, file_.data() + offset, size, offset, file_.size()))
+                {
+                    return;
+                }
+                offset += size;
+            } while(offset < file_.size());
+        }
+
+        void _stream(const Job& job_, std::vector<unsigned char>& buffer_)
+        {
+            std::FILE* file = std::fopen(job_.batch->paths[job_.index], "rb");
+            if(!file)
+            {
+                throw Error("Could not open file");
+            }
+            const std::unique_ptr<std::FILE, int (*)(std::FILE*)> closer{file, &std::fclose};
+
+            // ftell returns a long, which cannot hold the size of large files on Windows
+            std::error_code sizeError;
+            const std::uint64_t fileSize = std::filesystem::file_size(job_.batch->paths[job_.index], sizeError);
+            if(sizeError)
+            {
+                throw Error("Could not determine file size");
+            }
+
+            buffer_.resize(_options.chunkSize ? _options.chunkSize : 1024 * 1024);
+            std::uint64_t offset = 0;
+            do
+            {
+                const std::size_t size = std::fread(buffer_.data(), 1, buffer_.size(), file);
+                if(std::ferror(file))
+                {
+                    throw Error("Could not read file");
+                }
+                if(!_feed(job_, buffer_.data(), size, offset, fileSize))
+                {
+                    return;
+                }
+                offset += size;
+            } while(!std::feof(file));
+        }
+
+        void _process(const Job& job_, std::vector<unsigned char>& buffer_)
+        {
+            std::string error;
+            try
+            {
+                bool mapped = false;
+                if(_options.memoryMap)
+                {
+                    detail::MappedFile file;
+                    try
+                    {
+                        file = detail::MappedFile{job_.batch->paths[job_.index]};
+                        mapped = true;
+                    }
+                    catch(const Error&)
+                    {
+                    }
+                    if(mapped)
+                    {
+                        _map(job_, file);
+                    }
+                }
+                if(!mapped)
+                {
+                    _stream(job_, buffer_);
+                }
+            }
+            catch(const std::exception& exception_)
+            {
+                error = exception_.what();
+                if(error.empty())
+                {
+                    error = "Unknown error";
+                }
+            }
+            catch(...)
+            {
+                error = "Unknown error";
+            }
+            _notify({job_.batch, job_.index, true, 0, 0, std::move(error)});
+        }
+
+        void _work()
+        {
+            std::vector<unsigned char> buffer;
+            while(true)
+            {
+                Job job;
+                {
+                    std::unique_lock lock{_jobMutex};
+                    _jobAvailable.wait(lock, [this] {
+                        return _stopping || !_jobs.empty();
+                    });
+                    if(_stopping)
+                    {
+                        return;
+                    }
+                    job = std::move(_jobs.front());
+                    _jobs.pop_front();
+                }
+                _process(job, buffer);
+            }
+        }
+
+    public:
+        Event<const DropProgress&> progressEvent;
+        Event<const DropCompletion&> completionEvent;
+
+        explicit DropIngestor(ProcessorT processor_, const DropIngestionOptions& options_ = {}) :
+            _processor{std::move(processor_)},
+            _options{options_},
+            _nextDropId{1},
+            _pendingFiles{0},
+            _stopping{false}
+        {
+            _deliveryHook.attach(detail::postPollHooks, &DropIngestor::_onPoll, this);
+            const std::size_t workerCount = _options.workerCount ? _options.workerCount : 1;
+            _workers.reserve(workerCount);
+            for(std::size_t i = 0; i < workerCount; ++i)
+            {
+                _workers.emplace_back(&DropIngestor::_work, this);
+            }
+        }
+
+        DropIngestor(const DropIngestor&) = delete;
+        DropIngestor& operator=(const DropIngestor&) = delete;
+
+        // Files that have not been started are abandoned, running ones are finished
+        ~DropIngestor()
+        {
+            {
+                std::lock_guard lock{_jobMutex};
+                _stopping = true;
+            }
+            _jobAvailable.notify_all();
+            for(std::thread& worker : _workers)
+            {
+                worker.join();
+            }
+        }
+
+        // Ingests the files dropped on `window_` until the returned subscription is destroyed
+        [[nodiscard]] Subscription attach(Window& window_)
+        {
+            return window_.dropPathsEvent.subscribe([this](Window&, const PathsView& paths_) {
+                ingest(paths_);
+            });
+        }
+
+        // Copies the paths and queues them for processing. Returns the id
+        // reported in the progress and completion of the files.
+        std::uint64_t ingest(const PathsView& paths_)
+        {
+            auto batch = std::make_shared<Batch>();
+            batch->id = _nextDropId++;
+
+            std::size_t storageSize = 0;
+            for(const char* path : paths_)
+            {
+                storageSize += std::strlen(path) + 1;
+            }
+            batch->storage.resize(storageSize);
+            batch->paths.reserve(paths_.size());
+            char* cursor = batch->storage.data();
+            for(const char* path : paths_)
+            {
+                const std::size_t length = std::strlen(path) + 1;
+                std::memcpy(cursor, path, length);
+                batch->paths.push_back(cursor);
+                cursor += length;
+            }
+
+            {
+                std::lock_guard lock{_jobMutex};
+                for(std::size_t i = 0; i < paths_.size(); ++i)
+                {
+                    _jobs.push_back({batch, i});
+                }
+            }
+            _pendingFiles += paths_.size();
+            _jobAvailable.notify_all();
+            return batch->id;
+        }
+
+        // Invokes progressEvent and completionEvent for everything the
+        // workers reported so far. Called automatically after every
+        // pollEvents/waitEvents.
+        void deliver()
+        {
+            {
+                std::lock_guard lock{_notificationMutex};
+                _delivering.swap(_notifications);
+            }
+            for(const Notification& notification : _delivering)
+            {
+                const Batch& batch = *notification.batch;
+                if(notification.completed)
+                {
+                    --_pendingFiles;
+                    completionEvent(DropCompletion{batch.id,
+                            notification.index,
+                            batch.paths.size(),
+                            batch.paths[notification.index],
+                            notification.error.empty(),
+                            notification.error.empty() ? nullptr : notification.error.c_str()});
+                }
+                else
+                {
+                    progressEvent(DropProgress{batch.id,
+                            notification.index,
+                            batch.paths.size(),
+                            batch.paths[notification.index],
+                            notification.bytesProcessed,
+                            notification.fileSize});
+                }
+            }
+            _delivering.clear();
+        }
+
+        // Number of files dropped whose completion has not been delivered yet
+        [[nodiscard]] std::size_t getPendingFileCount() const noexcept
+        {
+            return _pendingFiles;
+        }
+
+        [[nodiscard]] bool isIdle() const noexcept
+        {
+            return _pendingFiles == 0;
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_DROP_INGESTION_H
@@ -1,45 +1,518 @@
 #ifndef GLFWPP_EVENT_H
 #define GLFWPP_EVENT_H
 
+#include "error.h"
+#include "helper.h"
+#include "profiling.h"
 #include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#ifndef GLFWPP_EVENT_MAX_SUBSCRIBERS
+    #define GLFWPP_EVENT_MAX_SUBSCRIBERS 8
+#endif
+
+#ifndef GLFWPP_EVENT_SUBSCRIBER_SIZE
+    #define GLFWPP_EVENT_SUBSCRIBER_SIZE (4 * sizeof(void*))
+#endif
 
 namespace glfw
 {
+    class Subscription;
+    class Window;
+
+    namespace detail
+    {
+        // Arguments are passed down to every handler by reference, so a
+        // dispatch never copies them no matter how many subscribers there are
+        template<typename T>
+        using EventParamT = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+        template<typename T>
+        void manageSubscriber(void* dst_, void* src_) noexcept
+        {
+            T* src = std::launder(static_cast<T*>(src_));
+            if(dst_)
+            {
+                new(dst_) T(std::move(*src));
+            }
+            src->~T();
+        }
+
+        class EventBase
+        {
+        protected:
+            static constexpr std::size_t _capacity = GLFWPP_EVENT_MAX_SUBSCRIBERS;
+            static constexpr std::size_t _storageSize = GLFWPP_EVENT_SUBSCRIBER_SIZE;
+            static_assert(_capacity <= 32, "GLFWPP_EVENT_MAX_SUBSCRIBERS must not exceed 32");
+
+            using ManagerT = void (*)(void*, void*) noexcept;
+            using ErasedInvokerT = void (*)();
+            using PresenceHookT = void (*)(void*, bool);
+
+            struct Slot
+            {
+                alignas(std::max_align_t) unsigned char storage[_storageSize];
+                ManagerT manager;
+                ErasedInvokerT invoker;
+                Subscription* token;
+            };
+
+            Slot _slots[_capacity];
+            std::uint32_t _occupied = 0;
+            std::uint32_t _pendingRemoval = 0;
+            unsigned _dispatchDepth = 0;
+
+            // Called with _presenceContext whenever a handler is added or
+            // removed. The flag is set when called from a noexcept path, where
+            // the hook must not throw and should only record the change.
+            PresenceHookT _presenceHook = nullptr;
+            void* _presenceContext = nullptr;
+
+            class DispatchGuard
+            {
+            private:
+                EventBase& _event;
+
+            public:
+                explicit DispatchGuard(EventBase& event_) noexcept :
+                    _event{event_}
+                {
+                    ++_event._dispatchDepth;
+                }
+
+                ~DispatchGuard() noexcept
+                {
+                    if(--_event._dispatchDepth == 0 && _event._pendingRemoval)
+                    {
+                        _event._collect();
+                    }
+                }
+            };
+
+        private:
+            friend class glfw::Subscription;
+            friend class glfw::Window;
+
+            inline void _unsubscribe(std::size_t index_) noexcept;
+            inline void _rebind(std::size_t index_, Subscription* token_) noexcept;
+            inline void _collect() noexcept;
+            inline void _moveFrom(EventBase& other_) noexcept;
+            inline void _clear() noexcept;
+
+        protected:
+            [[nodiscard]] std::size_t _acquireSlot() const
+            {
+                for(std::size_t i = 0; i < _capacity; ++i)
+                {
+                    if(!(_occupied & (1u << i)))
+                    {
+                        return i;
+                    }
+                }
+                throw Error("Event subscriber capacity exceeded");
+            }
+
+            [[nodiscard]] bool _hasSubscribers() const noexcept
+            {
+                return (_occupied & ~_pendingRemoval) != 0;
+            }
+
+            void _notifyPresence()
+            {
+                if(_presenceHook)
+                {
+                    _presenceHook(_presenceContext, false);
+                }
+            }
+
+            void _notifyPresenceDeferred() noexcept
+            {
+                if(_presenceHook)
+                {
+                    _presenceHook(_presenceContext, true);
+                }
+            }
+
+            void _setPresenceHook(PresenceHookT hook_, void* context_) noexcept
+            {
+                _presenceHook = hook_;
+                _presenceContext = context_;
+            }
+
+        public:
+            EventBase() noexcept = default;
+
+            EventBase(const EventBase&) = delete;
+            EventBase& operator=(const EventBase&) = delete;
+
+            EventBase(EventBase&& other_) noexcept
+            {
+                _moveFrom(other_);
+            }
+
+            EventBase& operator=(EventBase&& other_) noexcept
+            {
+                if(this != &other_)
+                {
+                    _clear();
+                    _moveFrom(other_);
+                }
+                return *this;
+            }
+
+            ~EventBase() noexcept
+            {
+                _clear();
+            }
+        };
+    }  // namespace detail
+
+    // RAII handle to a handler registered with Event::subscribe. The handler is
+    // removed when the Subscription is destroyed or reset.
+    class Subscription
+    {
+    private:
+        friend class detail::EventBase;
+        template<typename... Args>
+        friend class Event;
+
+        detail::EventBase* _event;
+        std::size_t _index;
+
+        Subscription(detail::EventBase* event_, std::size_t index_) noexcept :
+            _event{event_},
+            _index{index_}
+        {
+            _event->_rebind(_index, this);
+        }
+
+    public:
+        Subscription() noexcept :
+            _event{},
+            _index{}
+        {
+        }
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        Subscription(Subscription&& other_) noexcept :
+            _event{std::exchange(other_._event, nullptr)},
+            _index{other_._index}
+        {
+            if(_event)
+            {
+                _event->_rebind(_index, this);
+            }
+        }
+
+        Subscription& operator=(Subscription&& other_) noexcept
+        {
+            if(this != &other_)
+            {
+                reset();
+                _event = std::exchange(other_._event, nullptr);
+                _index = other_._index;
+                if(_event)
+                {
+                    _event->_rebind(_index, this);
+                }
+            }
+            return *this;
+        }
+
+        ~Subscription() noexcept
+        {
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            if(_event)
+            {
+                std::exchange(_event, nullptr)->_unsubscribe(_index);
+            }
+        }
+
+        // Keeps the handler registered for the whole lifetime of the event
+        void release() noexcept
+        {
+            if(_event)
+            {
+                std::exchange(_event, nullptr)->_rebind(_index, nullptr);
+            }
+        }
+
+        [[nodiscard]] bool isActive() const noexcept
+        {
+            return _event;
+        }
+    };
+
+    namespace detail
+    {
+        inline void EventBase::_unsubscribe(std::size_t index_) noexcept
+        {
+            Slot& slot = _slots[index_];
+            slot.token = nullptr;
+            if(_dispatchDepth)
+            {
+                // The handler may be the one currently running
+                _pendingRemoval |= 1u << index_;
+                return;
+            }
+            slot.manager(nullptr, slot.storage);
+            _occupied &= ~(1u << index_);
+            _notifyPresenceDeferred();
+        }
+
+        inline void EventBase::_rebind(std::size_t index_, Subscription* token_) noexcept
+        {
+            _slots[index_].token = token_;
+        }
+
+        inline void EventBase::_collect() noexcept
+        {
+            for(std::size_t i = 0; i < _capacity; ++i)
+            {
+                if(_pendingRemoval & (1u << i))
+                {
+                    _slots[i].manager(nullptr, _slots[i].storage);
+                }
+            }
+            _occupied &= ~_pendingRemoval;
+            _pendingRemoval = 0;
+            _notifyPresenceDeferred();
+        }
+
+        inline void EventBase::_moveFrom(EventBase& other_) noexcept
+        {
+            for(std::size_t i = 0; i < _capacity; ++i)
+            {
+                if(other_._occupied & (1u << i))
+                {
+                    Slot& src = other_._slots[i];
+                    Slot& dst = _slots[i];
+                    src.manager(dst.storage, src.storage);
+                    dst.manager = src.manager;
+                    dst.invoker = src.invoker;
+                    dst.token = src.token;
+                    if(dst.token)
+                    {
+                        dst.token->_event = this;
+                    }
+                }
+            }
+            _occupied = std::exchange(other_._occupied, 0);
+            _pendingRemoval = std::exchange(other_._pendingRemoval, 0);
+            _presenceHook = std::exchange(other_._presenceHook, nullptr);
+            _presenceContext = std::exchange(other_._presenceContext, nullptr);
+        }
+
+        inline void EventBase::_clear() noexcept
+        {
+            for(std::size_t i = 0; i < _capacity; ++i)
+            {
+                if(_occupied & (1u << i))
+                {
+                    Slot& slot = _slots[i];
+                    if(slot.token)
+                    {
+                        slot.token->_event = nullptr;
+                    }
+                    slot.manager(nullptr, slot.storage);
+                }
+            }
+            _occupied = 0;
+            _pendingRemoval = 0;
+        }
+    }  // namespace detail
+
     template<typename... Args>
-    class Event
+    class Event : public detail::EventBase
     {
     private:
+        using InvokerT = void (*)(void*, detail::EventParamT<Args>...);
+
         std::function<void(Args...)> _handler;
 
+        template<typename CallbackT>
+        static void _invoke(void* storage_, detail::EventParamT<Args>... args_)
+        {
+            (*std::launder(static_cast<CallbackT*>(storage_)))(args_...);
+        }
+
     public:
         template<typename CallbackT>
         void setCallback(CallbackT&& callback_)
         {
             _handler = std::forward<CallbackT>(callback_);
+            _notifyPresence();
+        }
+
+        // Registers an additional handler stored inline in the event, without
+        // touching the heap. Any number of subscribers up to
+        // GLFWPP_EVENT_MAX_SUBSCRIBERS may coexist with the callback.
+        template<typename CallbackT>
+        [[nodiscard]] Subscription subscribe(CallbackT&& callback_)
+        {
+            using StoredT = std::decay_t<CallbackT>;
+            static_assert(sizeof(StoredT) <= _storageSize, "Handler is too large to be stored inline, increase GLFWPP_EVENT_SUBSCRIBER_SIZE");
+            static_assert(alignof(StoredT) <= alignof(std::max_align_t), "Handler is over-aligned");
+            static_assert(std::is_nothrow_move_constructible_v<StoredT>, "Handler must be nothrow move constructible");
+            static_assert(std::is_invocable_v<StoredT&, detail::EventParamT<Args>...>, "Handler cannot be invoked with the event arguments");
+
+            const std::size_t index = _acquireSlot();
+            Slot& slot = _slots[index];
+            new(slot.storage) StoredT(std::forward<CallbackT>(callback_));
+            slot.manager = &detail::manageSubscriber<StoredT>;
+            slot.invoker = reinterpret_cast<ErasedInvokerT>(&_invoke<StoredT>);
+            _occupied |= 1u << index;
+
+            Subscription subscription{this, index};
+            _notifyPresence();
+            return subscription;
         }
-        void operator()(Args... args_)
+
+        [[nodiscard]] bool hasHandlers() const noexcept
+        {
+            return _handler || _hasSubscribers();
+        }
+
+        void operator()(detail::EventParamT<Args>... args_)
         {
             if(_handler)
             {
                 _handler(args_...);
             }
+            if(_occupied)
+            {
+                DispatchGuard guard{*this};
+                for(std::size_t i = 0; i < _capacity && (_occupied >> i) != 0; ++i)
+                {
+                    if((_occupied & ~_pendingRemoval) & (1u << i))
+                    {
+                        reinterpret_cast<InvokerT>(_slots[i].invoker)(_slots[i].storage, args_...);
+                    }
+                }
+            }
         }
     };
 
+    // Timer values (see getTimerValue) of the events received during one
+    // pollEvents or waitEvents call. Only collected while event timestamps
+    // are enabled.
+    struct PollStats
+    {
+        std::size_t eventCount = 0;
+        std::uint64_t earliestEventTimestamp = 0;
+        std::uint64_t latestEventTimestamp = 0;
+    };
+
+    namespace detail
+    {
+        // Invoked on entry of every pollEvents and waitEvents, before GLFW processes events
+        inline HookList<> pollBeginHooks;
+        // Invoked after every pollEvents and waitEvents, once GLFW has invoked all callbacks
+        inline HookList<> pollEndHooks;
+        // Invoked after pollEndHooks, once deferred events have been delivered as well
+        inline HookList<> postPollHooks;
+
+        inline bool eventTimestampsEnabled = false;
+        inline std::uint64_t eventTimestamp = 0;
+        inline PollStats currentPollStats;
+        inline PollStats lastPollStats;
+
+        // Called on entry of every GLFW callback. Returns the timestamp of the
+        // event, or 0 if timestamps are disabled.
+        inline std::uint64_t stampEvent()
+        {
+            if(!eventTimestampsEnabled)
+            {
+                return 0;
+            }
+
+            eventTimestamp = glfwGetTimerValue();
+            if(currentPollStats.eventCount++ == 0)
+            {
+                currentPollStats.earliestEventTimestamp = eventTimestamp;
+            }
+            currentPollStats.latestEventTimestamp = eventTimestamp;
+            return eventTimestamp;
+        }
+
+        inline void beginPoll()
+        {
+            currentPollStats = {};
+            pollBeginHooks();
+        }
+
+        inline void endPoll()
+        {
+            lastPollStats = currentPollStats;
+            GLFWPP_PROFILE_DEFERRED();
+            pollEndHooks();
+            postPollHooks();
+        }
+    }  // namespace detail
+
+    // While enabled, every window, monitor and joystick event is stamped with
+    // glfwGetTimerValue() when GLFW invokes its callback
+    inline void setEventTimestampsEnabled(bool enabled_)
+    {
+        detail::eventTimestampsEnabled = enabled_;
+    }
+
+    [[nodiscard]] inline bool getEventTimestampsEnabled()
+    {
+        return detail::eventTimestampsEnabled;
+    }
+
+    // Timestamp of the event whose handlers are running. Buffered and
+    // coalesced window events keep the time at which GLFW reported them.
+    [[nodiscard]] inline std::uint64_t getEventTimestamp()
+    {
+        return detail::eventTimestamp;
+    }
+
+    [[nodiscard]] inline PollStats getLastPollStats()
+    {
+        return detail::lastPollStats;
+    }
+
     inline void pollEvents()
     {
-        glfwPollEvents();
+        detail::beginPoll();
+        {
+            GLFWPP_PROFILE_POLL();
+            glfwPollEvents();
+        }
+        detail::endPoll();
     }
 
     inline void waitEvents()
     {
-        glfwWaitEvents();
+        detail::beginPoll();
+        {
+            GLFWPP_PROFILE_POLL();
+            glfwWaitEvents();
+        }
+        detail::endPoll();
     }
     inline void waitEvents(double timeout_)
     {
-        glfwWaitEventsTimeout(timeout_);
+        detail::beginPoll();
+        {
+            GLFWPP_PROFILE_POLL();
+            glfwWaitEventsTimeout(timeout_);
+        }
+        detail::endPoll();
     }
 
     inline void postEmptyEvent()
@@ -0,0 +1,75 @@
+#ifndef GLFWPP_FAKE_CLOCK_H
+#define GLFWPP_FAKE_CLOCK_H
+
+#include <cstdint>
+
+namespace glfw
+{
+    class FakeClock;
+
+    namespace detail
+    {
+        // Replaces the GLFW timer in getTime, setTime, getTimerValue and getTimerFrequency while set
+        inline FakeClock* fakeClock = nullptr;
+    }  // namespace detail
+
+    // Manually driven clock. While an instance exists it replaces the GLFW
+    // timer for glfw::getTime and friends, so code that reads the time behaves
+    // deterministically. Instances nest and must be destroyed in reverse order.
+    class FakeClock
+    {
+    private:
+        std::uint64_t _timerValue;
+        std::uint64_t _timerFrequency;
+        FakeClock* _previous;
+
+    public:
+        explicit FakeClock(std::uint64_t timerFrequency_ = 1'000'000'000, std::uint64_t timerValue_ = 0) noexcept :
+            _timerValue{timerValue_},
+            _timerFrequency{timerFrequency_},
+            _previous{detail::fakeClock}
+        {
+            detail::fakeClock = this;
+        }
+
+        FakeClock(const FakeClock&) = delete;
+        FakeClock& operator=(const FakeClock&) = delete;
+
+        ~FakeClock() noexcept
+        {
+            detail::fakeClock = _previous;
+        }
+
+        void setTimerValue(std::uint64_t timerValue_) noexcept
+        {
+            _timerValue = timerValue_;
+        }
+
+        void advance(std::uint64_t ticks_) noexcept
+        {
+            _timerValue += ticks_;
+        }
+
+        void setTime(double time_) noexcept
+        {
+            _timerValue = static_cast<std::uint64_t>(time_ * static_cast<double>(_timerFrequency));
+        }
+
+        [[nodiscard]] std::uint64_t getTimerValue() const noexcept
+        {
+            return _timerValue;
+        }
+
+        [[nodiscard]] std::uint64_t getTimerFrequency() const noexcept
+        {
+            return _timerFrequency;
+        }
+
+        [[nodiscard]] double getTime() const noexcept
+        {
+            return static_cast<double>(_timerValue) / static_cast<double>(_timerFrequency);
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_FAKE_CLOCK_H
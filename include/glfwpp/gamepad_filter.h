@@ -0,0 +1,527 @@
+#ifndef GLFWPP_GAMEPAD_FILTER_H
+#define GLFWPP_GAMEPAD_FILTER_H
+
+#include "event.h"
+#include "helper.h"
+#include "joystick.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+
+// Define GLFWPP_NO_SIMD to always use the scalar gamepad filter kernel
+#ifdef GLFWPP_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace glfw
+{
+    struct GamepadFilterConfig
+    {
+        // Stick inputs below the deadzone are zero, the rest is rescaled to
+        // start at zero. Radial deadzones act on the length of the stick
+        // vector and keep its direction, axial ones on each axis separately.
+        float leftStickDeadzone = 0.1f;
+        float rightStickDeadzone = 0.1f;
+        bool radialDeadzone = true;
+        // Blend between a linear (0) and a cubic (1) response for sticks and triggers
+        float responseCurve = 0;
+        // Triggers are reported from 0 to 1 after the deadzone and count as
+        // pressed from the threshold on
+        float triggerDeadzone = 0.05f;
+        float triggerThreshold = 0.5f;
+        // Exponential smoothing per update: 0 is off, values towards 1 react slower
+        float smoothing = 0;
+    };
+
+    // Gamepad state of all joystick slots. The axes are indexed by gamepad
+    // last, so one axis of all gamepads is contiguous.
+    struct GamepadBatch
+    {
+        static constexpr std::size_t gamepadCount = GLFW_JOYSTICK_LAST + 1;
+        static constexpr std::size_t axisCount = GLFW_GAMEPAD_AXIS_LAST + 1;
+
+        std::uint32_t presentMask;  // Bit i is set if gamepad i is connected
+        float axes[axisCount][gamepadCount];
+        std::uint16_t buttons[gamepadCount];  // Bit i is set while GamepadButton i is pressed
+        std::uint32_t leftTriggerMask;  // Bit i is set while the left trigger of gamepad i is pressed
+        std::uint32_t rightTriggerMask;
+    };
+
+    // Reads the unfiltered gamepad state of the joystick slots in `candidates_`
+    // (all by default). Entries of the other slots are zero.
+    inline void pollGamepads(GamepadBatch& batch_, std::uint32_t candidates_ = ~std::uint32_t{0})
+    {
+        batch_ = {};
+        for(std::size_t gamepad = 0; gamepad < GamepadBatch::gamepadCount; ++gamepad)
+        {
+            GLFWgamepadstate state;
+            if(!(candidates_ >> gamepad & 1) || !glfwGetGamepadState(static_cast<int>(gamepad), &state))
+            {
+                continue;
+            }
+
+            batch_.presentMask |= std::uint32_t{1} << gamepad;
+            std::uint16_t buttons = 0;
+            for(std::size_t button = 0; button <= GLFW_GAMEPAD_BUTTON_LAST; ++button)
+            {
+                buttons |= static_cast<std::uint16_t>((state.buttons[button] != GLFW_RELEASE) << button);
+            }
+            batch_.buttons[gamepad] = buttons;
+            for(std::size_t axis = 0; axis < GamepadBatch::axisCount; ++axis)
+            {
+                batch_.axes[axis][gamepad] = state.axes[axis];
+            }
+        }
+    }
+
+    namespace detail
+    {
+        // Parameters of the filter per gamepad, in the layout of the kernels
+        struct GamepadLanes
+        {
+            static constexpr std::size_t count = GamepadBatch::gamepadCount;
+
+            float stickDeadzone[2][count];
+            float stickScale[2][count];  // 1 / (1 - deadzone)
+            float radial[count];  // 1 for radial, 0 for axial deadzones
+            float curve[count];
+            float triggerDeadzone[count];
+            float triggerScale[count];
+            float triggerThreshold[count];
+            float follow[count];  // 1 - smoothing
+            float present[count];
+        };
+
+        struct GamepadScalarOps
+        {
+            static constexpr std::size_t width = 1;
+            using V = float;
+            using M = bool;
+
+            static V load(const float* p_)
+            {
+                return *p_;
+            }
+            static void store(float* p_, V v_)
+            {
+                *p_ = v_;
+            }
+            static V set(float v_)
+            {
+                return v_;
+            }
+            static V add(V a_, V b_)
+            {
+                return a_ + b_;
+            }
+            static V sub(V a_, V b_)
+            {
+                return a_ - b_;
+            }
+            static V mul(V a_, V b_)
+            {
+                return a_ * b_;
+            }
+            static V div(V a_, V b_)
+            {
+                return a_ / b_;
+            }
+            static V min(V a_, V b_)
+            {
+                return a_ < b_ ? a_ : b_;
+            }
+            static V max(V a_, V b_)
+            {
+                return a_ > b_ ? a_ : b_;
+            }
+            static V sqrt(V v_)
+            {
+                return std::sqrt(v_);
+            }
+            static V abs(V v_)
+            {
+                return std::fabs(v_);
+            }
+            static V copySign(V magnitude_, V sign_)
+            {
+                return std::copysign(magnitude_, sign_);
+            }
+            static M greater(V a_, V b_)
+            {
+                return a_ > b_;
+            }
+            static M greaterEqual(V a_, V b_)
+            {
+                return a_ >= b_;
+            }
+            static V select(M m_, V a_, V b_)
+            {
+                return m_ ? a_ : b_;
+            }
+            static unsigned bits(M m_)
+            {
+                return m_;
+            }
+        };
+
+#ifdef GLFWPP_SSE2
+        struct GamepadSse2Ops
+        {
+            static constexpr std::size_t width = 4;
+            using V = __m128;
+            using M = __m128;
+
+            static V load(const float* p_)
+            {
+                return _mm_loadu_ps(p_);
+            }
+            static void store(float* p_, V v_)
+            {
+                _mm_storeu_ps(p_, v_);
+            }
+            static V set(float v_)
+            {
+                return _mm_set1_ps(v_);
+            }
+            static V add(V a_, V b_)
+            {
+                return _mm_add_ps(a_, b_);
+            }
+            static V sub(V a_, V b_)
+            {
+                return _mm_sub_ps(a_, b_);
+            }
+            static V mul(V a_, V b_)
+            {
+                return _mm_mul_ps(a_, b_);
+            }
+            static V div(V a_, V b_)
+            {
+                return _mm_div_ps(a_, b_);
+            }
+            static V min(V a_, V b_)
+            {
+                return _mm_min_ps(a_, b_);
+            }
+            static V max(V a_, V b_)
+            {
+                return _mm_max_ps(a_, b_);
+            }
+            static V sqrt(V v_)
+            {
+                return _mm_sqrt_ps(v_);
+            }
+            static V abs(V v_)
+            {
+                return _mm_andnot_ps(_mm_set1_ps(-0.0f), v_);
+            }
+            static V copySign(V magnitude_, V sign_)
+            {
+                const V signBit = _mm_set1_ps(-0.0f);
+                return _mm_or_ps(_mm_andnot_ps(signBit, magnitude_), _mm_and_ps(signBit, sign_));
+            }
+            static M greater(V a_, V b_)
+            {
+                return _mm_cmpgt_ps(a_, b_);
+            }
+            static M greaterEqual(V a_, V b_)
+            {
+                return _mm_cmpge_ps(a_, b_);
+            }
+            static V select(M m_, V a_, V b_)
+            {
+                return _mm_or_ps(_mm_and_ps(m_, a_), _mm_andnot_ps(m_, b_));
+            }
+            static unsigned bits(M m_)
+            {
+                return static_cast<unsigned>(_mm_movemask_ps(m_));
+            }
+        };
+#endif
+
+        // Blends the linear and cubic response of `v_` in [0, 1]
+        template<typename Ops>
+        typename Ops::V applyCurve(typename Ops::V v_, typename Ops::V curve_)
+        {
+            const typename Ops::V cubic = Ops::mul(Ops::mul(v_, v_), v_);
+            return Ops::add(v_, Ops::mul(curve_, Ops::sub(cubic, v_)));
+        }
+
+        // Maps [deadzone, 1] to [0, 1], clamping values outside
+        template<typename Ops>
+        typename Ops::V rescale(typename Ops::V v_, typename Ops::V deadzone_, typename Ops::V scale_)
+        {
+            const typename Ops::V zero = Ops::set(0), one = Ops::set(1);
+            return Ops::min(Ops::max(Ops::mul(Ops::sub(v_, deadzone_), scale_), zero), one);
+        }
+
+        // Filters gamepads [begin_, end_) of `raw_` into `out_`, which holds the
+        // previous output for smoothing, and sets the pressed trigger bits
+        template<typename Ops>
+        void filterGamepads(const GamepadLanes& lanes_, const GamepadBatch& raw_, GamepadBatch& out_, std::size_t begin_, std::size_t end_)
+        {
+            using V = typename Ops::V;
+            const V zero = Ops::set(0), one = Ops::set(1), half = Ops::set(0.5f);
+
+            for(std::size_t i = begin_; i < end_; i += Ops::width)
+            {
+                const V radial = Ops::greater(Ops::load(lanes_.radial + i), zero);
+                const V curve = Ops::load(lanes_.curve + i);
+                const V follow = Ops::load(lanes_.follow + i);
+                const V present = Ops::load(lanes_.present + i);
+                V results[GamepadBatch::axisCount];
+
+                for(std::size_t stick = 0; stick < 2; ++stick)
+                {
+                    const std::size_t xAxis = stick == 0 ? GLFW_GAMEPAD_AXIS_LEFT_X : GLFW_GAMEPAD_AXIS_RIGHT_X;
+                    const std::size_t yAxis = stick == 0 ? GLFW_GAMEPAD_AXIS_LEFT_Y : GLFW_GAMEPAD_AXIS_RIGHT_Y;
+                    const V x = Ops::load(raw_.axes[xAxis] + i);
+                    const V y = Ops::load(raw_.axes[yAxis] + i);
+                    const V deadzone = Ops::load(lanes_.stickDeadzone[stick] + i);
+                    const V scale = Ops::load(lanes_.stickScale[stick] + i);
+
+                    // Radial: shape the length, keep the direction
+                    const V length = Ops::sqrt(Ops::add(Ops::mul(x, x), Ops::mul(y, y)));
+                    const V shaped = applyCurve<Ops>(rescale<Ops>(Ops::min(length, one), deadzone, scale), curve);
+                    const V factor = Ops::select(Ops::greater(length, zero), Ops::div(shaped, Ops::max(length, Ops::set(1e-12f))), zero);
+                    const V radialX = Ops::mul(x, factor);
+                    const V radialY = Ops::mul(y, factor);
+
+                    // Axial: shape every axis on its own
+                    const V axialX = Ops::copySign(applyCurve<Ops>(rescale<Ops>(Ops::abs(x), deadzone, scale), curve), x);
+                    const V axialY = Ops::copySign(applyCurve<Ops>(rescale<Ops>(Ops::abs(y), deadzone, scale), curve), y);
+
+                    results[xAxis] = Ops::select(radial, radialX, axialX);
+                    results[yAxis] = Ops::select(radial, radialY, axialY);
+                }
+
+                const V triggerDeadzone = Ops::load(lanes_.triggerDeadzone + i);
+                const V triggerScale = Ops::load(lanes_.triggerScale + i);
+                const V triggerThreshold = Ops::load(lanes_.triggerThreshold + i);
+                for(std::size_t axis : {std::size_t{GLFW_GAMEPAD_AXIS_LEFT_TRIGGER}, std::size_t{GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER}})
+                {
+                    const V value = Ops::mul(Ops::add(Ops::load(raw_.axes[axis] + i), one), half);
+                    results[axis] = applyCurve<Ops>(rescale<Ops>(value, triggerDeadzone, triggerScale), curve);
+                }
+
+                for(std::size_t axis = 0; axis < GamepadBatch::axisCount; ++axis)
+                {
+                    const V previous = Ops::load(out_.axes[axis] + i);
+                    const V smoothed = Ops::add(previous, Ops::mul(follow, Ops::sub(results[axis], previous)));
+                    Ops::store(out_.axes[axis] + i, Ops::mul(smoothed, present));
+                }
+
+                const unsigned presentBits = Ops::bits(Ops::greater(present, zero));
+                const V leftTrigger = Ops::load(out_.axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER] + i);
+                const V rightTrigger = Ops::load(out_.axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] + i);
+                out_.leftTriggerMask |= (Ops::bits(Ops::greaterEqual(leftTrigger, triggerThreshold)) & presentBits) << i;
+                out_.rightTriggerMask |= (Ops::bits(Ops::greaterEqual(rightTrigger, triggerThreshold)) & presentBits) << i;
+            }
+        }
+    }  // namespace detail
+
+    // Filters all connected gamepads in one batch: stick deadzones (radial or
+    // axial), response curves, trigger deadzones and thresholds and
+    // smoothing. Configurations are selected by joystick GUID and looked up
+    // only when a gamepad connects. Uses SSE2 kernels where available and a
+    // scalar fallback otherwise.
+    class GamepadFilter
+    {
+    private:
+        GamepadFilterConfig _defaultConfig;
+        std::vector<std::pair<std::string, GamepadFilterConfig>> _configs;
+
+        detail::GamepadLanes _lanes;
+        std::uint32_t _configuredMask;
+        GamepadBatch _raw;
+        GamepadBatch _filtered;
+        bool _simd;
+
+        detail::Hook<Joystick, JoystickEvent> _joystickHook;
+
+        // A gamepad that reconnects, possibly a different one, is configured again
+        static void _onJoystick(void* filter_, Joystick joystick_, JoystickEvent)
+        {
+            static_cast<GamepadFilter*>(filter_)->_configuredMask &= ~(std::uint32_t{1} << static_cast<int>(joystick_));
+        }
+
+        void _setLane(std::size_t gamepad_, const GamepadFilterConfig& config_) noexcept
+        {
+            const float stickDeadzones[] = {config_.leftStickDeadzone, config_.rightStickDeadzone};
+            for(std::size_t stick = 0; stick < 2; ++stick)
+            {
+                const float deadzone = std::clamp(stickDeadzones[stick], 0.0f, 0.99f);
+                _lanes.stickDeadzone[stick][gamepad_] = deadzone;
+                _lanes.stickScale[stick][gamepad_] = 1 / (1 - deadzone);
+            }
+            _lanes.radial[gamepad_] = config_.radialDeadzone ? 1.0f : 0.0f;
+            _lanes.curve[gamepad_] = std::clamp(config_.responseCurve, 0.0f, 1.0f);
+            const float triggerDeadzone = std::clamp(config_.triggerDeadzone, 0.0f, 0.99f);
+            _lanes.triggerDeadzone[gamepad_] = triggerDeadzone;
+            _lanes.triggerScale[gamepad_] = 1 / (1 - triggerDeadzone);
+            _lanes.triggerThreshold[gamepad_] = config_.triggerThreshold;
+            _lanes.follow[gamepad_] = 1 - std::clamp(config_.smoothing, 0.0f, 0.99f);
+        }
+
+        [[nodiscard]] const GamepadFilterConfig& _findConfig(const char* guid_) const noexcept
+        {
+            if(guid_)
+            {
+                for(const auto& [guid, config] : _configs)
+                {
+                    if(guid == guid_)
+                    {
+                        return config;
+                    }
+                }
+            }
+            return _defaultConfig;
+        }
+
+        // Resolves the configuration of newly connected gamepads
+        void _configure(std::uint32_t presentMask_)
+        {
+            const std::uint32_t connected = presentMask_ & ~_configuredMask;
+            for(std::size_t gamepad = 0; gamepad < GamepadBatch::gamepadCount; ++gamepad)
+            {
+                if(connected >> gamepad & 1)
+                {
+                    _setLane(gamepad, _findConfig(glfwGetJoystickGUID(static_cast<int>(gamepad))));
+                    // Do not smooth from the state of a previous gamepad
+                    for(auto& axis : _filtered.axes)
+                    {
+                        axis[gamepad] = 0;
+                    }
+                }
+                _lanes.present[gamepad] = presentMask_ >> gamepad & 1 ? 1.0f : 0.0f;
+            }
+            _configuredMask = presentMask_;
+        }
+
+    public:
+        explicit GamepadFilter(const GamepadFilterConfig& defaultConfig_ = {}) :
+            _defaultConfig{defaultConfig_},
+            _configs{},
+            _lanes{},
+            _configuredMask{0},
+            _raw{},
+            _filtered{},
+#ifdef GLFWPP_SSE2
+            _simd{true}
+#else
+            _simd{false}
+#endif
+        {
+            _joystickHook.attach(detail::joystickHooks, &GamepadFilter::_onJoystick, this);
+        }
+
+        GamepadFilter(const GamepadFilter&) = delete;
+        GamepadFilter& operator=(const GamepadFilter&) = delete;
+
+        void setDefaultConfig(const GamepadFilterConfig& config_)
+        {
+            _defaultConfig = config_;
+            _configuredMask = 0;
+        }
+
+        [[nodiscard]] const GamepadFilterConfig& getDefaultConfig() const noexcept
+        {
+            return _defaultConfig;
+        }
+
+        // Configuration for gamepads whose Joystick::getGuid() is `guid_`
+        void setConfig(const std::string& guid_, const GamepadFilterConfig& config_)
+        {
+            const auto it = std::find_if(_configs.begin(), _configs.end(), [&](const auto& entry_) {
+                return entry_.first == guid_;
+            });
+            if(it != _configs.end())
+            {
+                it->second = config_;
+            }
+            else
+            {
+                _configs.emplace_back(guid_, config_);
+            }
+            _configuredMask = 0;
+        }
+
+        void removeConfig(const std::string& guid_)
+        {
+            _configs.erase(std::remove_if(_configs.begin(), _configs.end(), [&](const auto& entry_) {
+                return entry_.first == guid_;
+            }),
+                    _configs.end());
+            _configuredMask = 0;
+        }
+
+        // Only has an effect if the SIMD kernels are compiled in
+        void setSimdEnabled(bool enabled_) noexcept
+        {
+#ifdef GLFWPP_SSE2
+            _simd = enabled_;
+#else
+            (void)enabled_;
+#endif
+        }
+
+        [[nodiscard]] bool getSimdEnabled() const noexcept
+        {
+            return _simd;
+        }
+
+        // Reads the gamepad state of every joystick slot from GLFW and filters it
+        const GamepadBatch& update()
+        {
+            pollGamepads(_raw);
+            return filter(_raw);
+        }
+
+        // Filters a batch read elsewhere. Axes of gamepads that are not
+        // present in `raw_` are zero in the result.
+        const GamepadBatch& filter(const GamepadBatch& raw_)
+        {
+            if(raw_.presentMask != _configuredMask)
+            {
+                _configure(raw_.presentMask);
+            }
+
+            _filtered.presentMask = raw_.presentMask;
+            std::copy(std::begin(raw_.buttons), std::end(raw_.buttons), std::begin(_filtered.buttons));
+            _filtered.leftTriggerMask = 0;
+            _filtered.rightTriggerMask = 0;
+#ifdef GLFWPP_SSE2
+            if(_simd)
+            {
+                detail::filterGamepads<detail::GamepadSse2Ops>(_lanes, raw_, _filtered, 0, GamepadBatch::gamepadCount);
+                return _filtered;
+            }
+#endif
+            detail::filterGamepads<detail::GamepadScalarOps>(_lanes, raw_, _filtered, 0, GamepadBatch::gamepadCount);
+            return _filtered;
+        }
+
+        // The result of the last update() or filter()
+        [[nodiscard]] const GamepadBatch& getFiltered() const noexcept
+        {
+            return _filtered;
+        }
+
+        // The unfiltered state read by the last update()
+        [[nodiscard]] const GamepadBatch& getRaw() const noexcept
+        {
+            return _raw;
+        }
+    };
+}  // namespace glfw
+
+#endif
+
+#endif  //GLFWPP_GAMEPAD_FILTER_H
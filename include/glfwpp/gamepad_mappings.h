@@ -0,0 +1,379 @@
+#ifndef GLFWPP_GAMEPAD_MAPPINGS_H
+#define GLFWPP_GAMEPAD_MAPPINGS_H
+
+#include "error.h"
+#include "event.h"
+#include "joystick.h"
+#include "mapped_file.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace glfw
+{
+    // Binary gamepad mapping database format (all integers little endian):
+    //   header: magic "GLFWPPGM", uint32 version (1), uint32 entry count
+    //   index:  per entry 32 bytes of lower case GUID, uint32 offset and
+    //           uint32 length of its mapping line, sorted by GUID
+    //   lines:  the SDL mapping lines, each followed by a NUL byte; offsets
+    //           are relative to the start of this section
+    namespace detail
+    {
+        constexpr char gamepadMappingsMagic[8] = {'G', 'L', 'F', 'W', 'P', 'P', 'G', 'M'};
+        constexpr std::uint32_t gamepadMappingsVersion = 1;
+        constexpr std::size_t gamepadMappingsHeaderSize = 16;
+        constexpr std::size_t gamepadGuidLength = 32;
+        constexpr std::size_t gamepadMappingsEntrySize = gamepadGuidLength + 8;
+
+        inline void writeUint32(std::ostream& output_, std::uint32_t value_)
+        {
+            const char bytes[] = {
+                    static_cast<char>(value_ & 0xFF),
+                    static_cast<char>(value_ >> 8 & 0xFF),
+                    static_cast<char>(value_ >> 16 & 0xFF),
+                    static_cast<char>(value_ >> 24 & 0xFF)};
+            output_.write(bytes, sizeof(bytes));
+        }
+
+        [[nodiscard]] inline std::uint32_t readUint32(const unsigned char* bytes_) noexcept
+        {
+            return static_cast<std::uint32_t>(bytes_[0]) | static_cast<std::uint32_t>(bytes_[1]) << 8 |
+                   static_cast<std::uint32_t>(bytes_[2]) << 16 | static_cast<std::uint32_t>(bytes_[3]) << 24;
+        }
+
+        // Copies the GUID in lower case, returns false if it is not 32 hex digits
+        [[nodiscard]] inline bool normalizeGamepadGuid(std::string_view guid_, char* output_) noexcept
+        {
+            if(guid_.size() != gamepadGuidLength)
+            {
+                return false;
+            }
+            for(std::size_t i = 0; i < gamepadGuidLength; ++i)
+            {
+                char c = guid_[i];
+                if(c >= 'A' && c <= 'F')
+                {
+                    c = static_cast<char>(c - 'A' + 'a');
+                }
+                if(!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+                {
+                    return false;
+                }
+                output_[i] = c;
+            }
+            return true;
+        }
+    }  // namespace detail
+
+    // Build step: converts SDL gamepad mapping text (e.g. gamecontrollerdb.txt)
+    // into the binary database read by GamepadMappingDatabase. Empty lines,
+    // comments and lines without a valid GUID are skipped. Returns the number
+    // of mappings written.
+    inline std::size_t compileGamepadMappings(std::string_view text_, std::ostream& output_)
+    {
+        struct Line
+        {
+            char guid[detail::gamepadGuidLength];
+            std::string_view text;
+        };
+        std::vector<Line> lines;
+
+        while(!text_.empty())
+        {
+            const std::size_t end = std::min(text_.find('\n'), text_.size());
+            std::string_view line = text_.substr(0, end);
+            text_.remove_prefix(std::min(end + 1, text_.size()));
+
+            while(!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t'))
+            {
+                line.remove_suffix(1);
+            }
+            while(!line.empty() && (line.front() == ' ' || line.front() == '\t'))
+            {
+                line.remove_prefix(1);
+            }
+            if(line.empty() || line.front() == '#')
+            {
+                continue;
+            }
+
+            Line entry;
+            if(detail::normalizeGamepadGuid(line.substr(0, line.find(',')), entry.guid))
+            {
+                entry.text = line;
+                lines.push_back(entry);
+            }
+        }
+
+        // Stable, so entries of one GUID (for different platforms) keep their order
+        std::stable_sort(lines.begin(), lines.end(), [](const Line& lhs_, const Line& rhs_) {
+            return std::memcmp(lhs_.guid, rhs_.guid, detail::gamepadGuidLength) < 0;
+        });
+
+        output_.write(detail::gamepadMappingsMagic, sizeof(detail::gamepadMappingsMagic));
+        detail::writeUint32(output_, detail::gamepadMappingsVersion);
+        detail::writeUint32(output_, static_cast<std::uint32_t>(lines.size()));
+
+        std::uint32_t offset = 0;
+        for(const Line& line : lines)
+        {
+            output_.write(line.guid, detail::gamepadGuidLength);
+            detail::writeUint32(output_, offset);
+            detail::writeUint32(output_, static_cast<std::uint32_t>(line.text.size()));
+            offset += static_cast<std::uint32_t>(line.text.size() + 1);
+        }
+        for(const Line& line : lines)
+        {
+            output_.write(line.text.data(), static_cast<std::streamsize>(line.text.size()));
+            output_.put('\0');
+        }
+
+        if(!output_)
+        {
+            throw Error("Could not write gamepad mapping database");
+        }
+        return lines.size();
+    }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+    // Memory maps a database written by compileGamepadMappings and passes
+    // GLFW only the mappings of joysticks that are actually connected. With
+    // lazy loading enabled, the mappings of joysticks connected later are
+    // added from joystickEvent. Every mapping is passed to GLFW until it is
+    // accepted once.
+    class GamepadMappingDatabase
+    {
+    private:
+        detail::MappedFile _file;
+        std::size_t _entryCount;
+        const unsigned char* _index;
+        const char* _lines;
+        std::size_t _linesSize;
+        std::vector<bool> _applied;
+        std::size_t _appliedCount;
+        std::size_t _failedCount;
+        detail::Hook<Joystick, JoystickEvent> _joystickHook;
+
+        // Runs inside the GLFW joystick callback, so failures are only counted
+        static void _onJoystick(void* database_, Joystick joystick_, JoystickEvent event_)
+        {
+            if(event_ != JoystickEvent::Connected)
+            {
+                return;
+            }
+
+            GamepadMappingDatabase& database = *static_cast<GamepadMappingDatabase*>(database_);
+            std::size_t failed = 0;
+            try
+            {
+                (void)database._apply(joystick_.getGuid(), failed);
+            }
+            catch(const Error&)
+            {
+                ++database._failedCount;
+            }
+        }
+
+        // Passes the mappings of `guid_` that GLFW has not accepted yet and
+        // adds the number of rejected ones to `failed_`
+        std::size_t _apply(const char* guid_, std::size_t& failed_)
+        {
+            std::size_t first = 0;
+            const std::size_t count = find(guid_, first);
+            std::size_t applied = 0;
+            for(std::size_t entry = first; entry < first + count; ++entry)
+            {
+                if(_applied[entry])
+                {
+                    continue;
+                }
+                if(glfwUpdateGamepadMappings(getMapping(entry)))
+                {
+                    _applied[entry] = true;
+                    ++_appliedCount;
+                    ++applied;
+                }
+                else
+                {
+                    ++_failedCount;
+                    ++failed_;
+                }
+            }
+            return applied;
+        }
+
+        [[nodiscard]] const char* _guidAt(std::size_t entry_) const noexcept
+        {
+            return reinterpret_cast<const char*>(_index + entry_ * detail::gamepadMappingsEntrySize);
+        }
+
+        void _validate()
+        {
+            const std::size_t size = _file.size();
+            const unsigned char* data = _file.data();
+            if(size < detail::gamepadMappingsHeaderSize ||
+                    std::memcmp(data, detail::gamepadMappingsMagic, sizeof(detail::gamepadMappingsMagic)) != 0 ||
+                    detail::readUint32(data + 8) != detail::gamepadMappingsVersion)
+            {
+                throw Error("Invalid gamepad mapping database");
+            }
+
+            _entryCount = detail::readUint32(data + 12);
+            const std::size_t indexSize = _entryCount * detail::gamepadMappingsEntrySize;
+            if(indexSize > size - detail::gamepadMappingsHeaderSize)
+            {
+                throw Error("Invalid gamepad mapping database");
+            }
+            _index = data + detail::gamepadMappingsHeaderSize;
+            _lines = reinterpret_cast<const char*>(_index + indexSize);
+            _linesSize = size - detail::gamepadMappingsHeaderSize - indexSize;
+
+            for(std::size_t entry = 0; entry < _entryCount; ++entry)
+            {
+                const unsigned char* record = _index + entry * detail::gamepadMappingsEntrySize + detail::gamepadGuidLength;
+                const std::size_t offset = detail::readUint32(record);
+                const std::size_t length = detail::readUint32(record + 4);
+                if(offset >= _linesSize || length >= _linesSize - offset || _lines[offset + length] != '\0')
+                {
+                    throw Error("Invalid gamepad mapping database");
+                }
+            }
+        }
+
+    public:
+        explicit GamepadMappingDatabase(const char* path_) :
+            _file{path_},
+            _entryCount{0},
+            _index{nullptr},
+            _lines{nullptr},
+            _linesSize{0},
+            _applied{},
+            _appliedCount{0},
+            _failedCount{0},
+            _joystickHook{}
+        {
+            _validate();
+            _applied.resize(_entryCount);
+        }
+
+        GamepadMappingDatabase(const GamepadMappingDatabase&) = delete;
+        GamepadMappingDatabase& operator=(const GamepadMappingDatabase&) = delete;
+
+        [[nodiscard]] std::size_t getEntryCount() const noexcept
+        {
+            return _entryCount;
+        }
+
+        // Number of mappings passed to GLFW so far
+        [[nodiscard]] std::size_t getAppliedCount() const noexcept
+        {
+            return _appliedCount;
+        }
+
+        // Number of times GLFW rejected a mapping, including those passed by lazy loading
+        [[nodiscard]] std::size_t getFailedCount() const noexcept
+        {
+            return _failedCount;
+        }
+
+        // Binary search for the mapping lines of `guid_`. Returns their count
+        // and the index of the first one in `first_`.
+        [[nodiscard]] std::size_t find(const char* guid_, std::size_t& first_) const noexcept
+        {
+            char key[detail::gamepadGuidLength];
+            if(!guid_ || !detail::normalizeGamepadGuid(guid_, key))
+            {
+                return 0;
+            }
+
+            std::size_t low = 0, high = _entryCount;
+            while(low < high)
+            {
+                const std::size_t middle = low + (high - low) / 2;
+                if(std::memcmp(_guidAt(middle), key, detail::gamepadGuidLength) < 0)
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            first_ = low;
+            std::size_t last = low;
+            while(last < _entryCount && std::memcmp(_guidAt(last), key, detail::gamepadGuidLength) == 0)
+            {
+                ++last;
+            }
+            return last - low;
+        }
+
+        // The mapping line of an entry, as it appeared in the source text
+        [[nodiscard]] const char* getMapping(std::size_t entry_) const noexcept
+        {
+            return _lines + detail::readUint32(_index + entry_ * detail::gamepadMappingsEntrySize + detail::gamepadGuidLength);
+        }
+
+        // Passes the mappings of `guid_` to GLFW unless GLFW already accepted
+        // them. Returns the number of mappings passed now. Throws if GLFW
+        // rejected any of them, after passing the others; rejected mappings
+        // are passed again by the next call.
+        std::size_t apply(const char* guid_)
+        {
+            std::size_t failed = 0;
+            const std::size_t applied = _apply(guid_, failed);
+            if(failed)
+            {
+                throw Error("Invalid gamepad mapping");
+            }
+            return applied;
+        }
+
+        // Applies the mappings of every connected joystick, see apply
+        std::size_t applyConnected()
+        {
+            std::size_t applied = 0;
+            std::size_t failed = 0;
+            for(int jid = GLFW_JOYSTICK_1; jid <= GLFW_JOYSTICK_LAST; ++jid)
+            {
+                if(glfwJoystickPresent(jid))
+                {
+                    applied += _apply(glfwGetJoystickGUID(jid), failed);
+                }
+            }
+            if(failed)
+            {
+                throw Error("Invalid gamepad mapping");
+            }
+            return applied;
+        }
+
+        // Applies the mappings of joysticks as they connect. The database must
+        // stay alive while enabled. Rejected mappings are counted in
+        // getFailedCount instead of throwing from the joystick callback.
+        void setLazyLoadingEnabled(bool enabled_)
+        {
+            if(!enabled_)
+            {
+                _joystickHook.reset();
+            }
+            else if(!_joystickHook.isActive())
+            {
+                _joystickHook.attach(detail::joystickHooks, &GamepadMappingDatabase::_onJoystick, this);
+            }
+        }
+
+        [[nodiscard]] bool getLazyLoadingEnabled() const noexcept
+        {
+            return _joystickHook.isActive();
+        }
+    };
+#endif
+}  // namespace glfw
+
+#endif  //GLFWPP_GAMEPAD_MAPPINGS_H
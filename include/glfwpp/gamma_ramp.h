@@ -0,0 +1,438 @@
+#ifndef GLFWPP_GAMMA_RAMP_H
+#define GLFWPP_GAMMA_RAMP_H
+
+#include "error.h"
+#include "glfwpp.h"
+#include "helper.h"
+#include "monitor.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Define GLFWPP_NO_SIMD to always use the scalar gamma ramp kernel
+#ifdef GLFWPP_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace glfw
+{
+    // Parametric description of a gamma ramp. An input x from 0 to 1 maps to
+    // pow(clamp((x - 0.5) * contrast + 0.5 + brightness), 1 / gamma), scaled
+    // per channel by the white point of the color temperature (neutral at
+    // 6500 K, warmer below).
+    struct GammaCurve
+    {
+        float gamma = 1;
+        float brightness = 0;
+        float contrast = 1;
+        float temperature = 6500;  // Kelvin, 1000 to 40000
+    };
+
+    namespace detail
+    {
+        struct GammaCoefficients
+        {
+            float contrast;
+            float offset;
+            float exponent;
+            float white[3];
+        };
+
+        // RGB of a black body at `kelvin_`, after Tanner Helland's fit
+        inline void blackBodyColor(float kelvin_, float* rgb_) noexcept
+        {
+            const double t = std::clamp(static_cast<double>(kelvin_), 1000.0, 40000.0) / 100;
+            const double red = t <= 66 ? 255 : 329.698727446 * std::pow(t - 60, -0.1332047592);
+            const double green = t <= 66 ? 99.4708025861 * std::log(t) - 161.1195681661 : 288.1221695283 * std::pow(t - 60, -0.0755148492);
+            const double blue = t >= 66 ? 255 : t <= 19 ? 0 : 138.5177312231 * std::log(t - 10) - 305.0447927307;
+            rgb_[0] = static_cast<float>(std::clamp(red / 255, 0.0, 1.0));
+            rgb_[1] = static_cast<float>(std::clamp(green / 255, 0.0, 1.0));
+            rgb_[2] = static_cast<float>(std::clamp(blue / 255, 0.0, 1.0));
+        }
+
+        [[nodiscard]] inline GammaCoefficients gammaCoefficients(const GammaCurve& curve_)
+        {
+            if(!(curve_.gamma > 0) || !std::isfinite(curve_.gamma))
+            {
+                throw Error("Invalid gamma");
+            }
+
+            GammaCoefficients coefficients{};
+            coefficients.contrast = curve_.contrast;
+            coefficients.offset = 0.5f - 0.5f * curve_.contrast + curve_.brightness;
+            coefficients.exponent = 1 / curve_.gamma;
+
+            float neutral[3];
+            blackBodyColor(6500, neutral);
+            blackBodyColor(curve_.temperature, coefficients.white);
+            for(int channel = 0; channel < 3; ++channel)
+            {
+                coefficients.white[channel] = std::min(coefficients.white[channel] / neutral[channel], 1.0f);
+            }
+            return coefficients;
+        }
+
+        inline void fillGammaRampScalar(const GammaCoefficients& coefficients_, std::size_t size_, unsigned short* red_, unsigned short* green_, unsigned short* blue_) noexcept
+        {
+            const float step = size_ > 1 ? 1.0f / static_cast<float>(size_ - 1) : 0.0f;
+            unsigned short* channels[] = {red_, green_, blue_};
+            for(std::size_t i = 0; i < size_; ++i)
+            {
+                float value = std::clamp(static_cast<float>(i) * step * coefficients_.contrast + coefficients_.offset, 0.0f, 1.0f);
+                value = value > 0 ? std::pow(value, coefficients_.exponent) : 0;
+                for(int channel = 0; channel < 3; ++channel)
+                {
+                    channels[channel][i] = static_cast<unsigned short>(std::min(value * coefficients_.white[channel], 1.0f) * 65535 + 0.5f);
+                }
+            }
+        }
+
+#ifdef GLFWPP_SSE2
+        // log2 for positive normal inputs, absolute error below 1e-6
+        [[nodiscard]] inline __m128 log2Sse2(__m128 x_) noexcept
+        {
+            const __m128i bits = _mm_castps_si128(x_);
+            const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+            const __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+            // log2(m) = 2 / ln(2) * atanh((m - 1) / (m + 1)), the argument is at most 1/3
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+            const __m128 t2 = _mm_mul_ps(t, t);
+            __m128 series = _mm_set1_ps(1.0f / 11);
+            series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 9));
+            series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 7));
+            series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 5));
+            series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 3));
+            series = _mm_add_ps(_mm_mul_ps(series, t2), one);
+            return _mm_add_ps(exponent, _mm_mul_ps(_mm_mul_ps(series, t), _mm_set1_ps(2.8853900817779268f)));
+        }
+
+        // exp2 for inputs from -126 to 127, relative error below 1e-6
+        [[nodiscard]] inline __m128 exp2Sse2(__m128 x_) noexcept
+        {
+            const __m128i whole = _mm_cvtps_epi32(x_);
+            const __m128 fraction = _mm_mul_ps(_mm_sub_ps(x_, _mm_cvtepi32_ps(whole)), _mm_set1_ps(0.69314718055994531f));
+
+            // exp(f) for |f| <= ln(2) / 2
+            __m128 series = _mm_set1_ps(1.0f / 720);
+            series = _mm_add_ps(_mm_mul_ps(series, fraction), _mm_set1_ps(1.0f / 120));
+            series = _mm_add_ps(_mm_mul_ps(series, fraction), _mm_set1_ps(1.0f / 24));
+            series = _mm_add_ps(_mm_mul_ps(series, fraction), _mm_set1_ps(1.0f / 6));
+            series = _mm_add_ps(_mm_mul_ps(series, fraction), _mm_set1_ps(0.5f));
+            series = _mm_add_ps(_mm_mul_ps(series, fraction), _mm_set1_ps(1.0f));
+            series = _mm_add_ps(_mm_mul_ps(series, fraction), _mm_set1_ps(1.0f));
+
+            const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(whole, _mm_set1_epi32(127)), 23));
+            return _mm_mul_ps(series, scale);
+        }
+
+        inline void fillGammaRampSse2(const GammaCoefficients& coefficients_, std::size_t size_, unsigned short* red_, unsigned short* green_, unsigned short* blue_) noexcept
+        {
+            const __m128 step = _mm_set1_ps(size_ > 1 ? 1.0f / static_cast<float>(size_ - 1) : 0.0f);
+            const __m128 contrast = _mm_set1_ps(coefficients_.contrast);
+            const __m128 offset = _mm_set1_ps(coefficients_.offset);
+            const __m128 exponent = _mm_set1_ps(coefficients_.exponent);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 minExponent = _mm_set1_ps(-126.0f);
+            const __m128 white[] = {
+                    _mm_mul_ps(_mm_set1_ps(coefficients_.white[0]), _mm_set1_ps(65535.0f)),
+                    _mm_mul_ps(_mm_set1_ps(coefficients_.white[1]), _mm_set1_ps(65535.0f)),
+                    _mm_mul_ps(_mm_set1_ps(coefficients_.white[2]), _mm_set1_ps(65535.0f))};
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128i bias = _mm_set1_epi32(32768);
+            const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+            unsigned short* channels[] = {red_, green_, blue_};
+
+            __m128 index = _mm_setr_ps(0, 1, 2, 3);
+            const __m128 advance = _mm_set1_ps(8);
+            for(std::size_t i = 0; i < size_; i += 8)
+            {
+                __m128 values[2];
+                for(int part = 0; part < 2; ++part)
+                {
+                    const __m128 lane = _mm_add_ps(index, _mm_set1_ps(static_cast<float>(4 * part)));
+                    __m128 value = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(lane, step), contrast), offset);
+                    value = _mm_min_ps(_mm_max_ps(value, zero), one);
+                    const __m128 positive = _mm_cmpgt_ps(value, zero);
+                    const __m128 power = exp2Sse2(_mm_max_ps(_mm_mul_ps(log2Sse2(value), exponent), minExponent));
+                    values[part] = _mm_and_ps(_mm_min_ps(power, one), positive);
+                }
+                index = _mm_add_ps(index, advance);
+
+                for(int channel = 0; channel < 3; ++channel)
+                {
+                    // No unsigned 32 to 16 bit pack in SSE2: pack with a signed bias and flip it back
+                    const __m128i low = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(values[0], white[channel]), half)), bias);
+                    const __m128i high = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(values[1], white[channel]), half)), bias);
+                    const __m128i packed = _mm_xor_si128(_mm_packs_epi32(low, high), flip);
+                    if(i + 8 <= size_)
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(channels[channel] + i), packed);
+                    }
+                    else
+                    {
+                        alignas(16) unsigned short tail[8];
+                        _mm_store_si128(reinterpret_cast<__m128i*>(tail), packed);
+                        std::memcpy(channels[channel] + i, tail, (size_ - i) * sizeof(unsigned short));
+                    }
+                }
+            }
+        }
+#endif
+
+        inline void fillGammaRamp(const GammaCurve& curve_, bool simd_, std::size_t size_, unsigned short* red_, unsigned short* green_, unsigned short* blue_)
+        {
+            const GammaCoefficients coefficients = gammaCoefficients(curve_);
+#ifdef GLFWPP_SSE2
+            if(simd_)
+            {
+                fillGammaRampSse2(coefficients, size_, red_, green_, blue_);
+                return;
+            }
+#else
+            (void)simd_;
+#endif
+            fillGammaRampScalar(coefficients, size_, red_, green_, blue_);
+        }
+
+        [[nodiscard]] inline std::size_t gammaRampSize(Monitor monitor_)
+        {
+            const GLFWgammaramp* ramp = glfwGetGammaRamp(static_cast<GLFWmonitor*>(monitor_));
+            if(!ramp)
+            {
+                throw Error("Monitor has no gamma ramp");
+            }
+            return ramp->size;
+        }
+    }  // namespace detail
+
+    // Generates gamma ramps from a GammaCurve into storage it owns and
+    // reuses. The ramp size must match the monitor (typically 256).
+    class GammaRampBuilder
+    {
+    private:
+        std::vector<unsigned short> _values;
+        GammaRamp _ramp;
+        bool _simd;
+
+    public:
+        explicit GammaRampBuilder(std::size_t size_ = 256) :
+            _values(3 * size_),
+            _ramp{},
+#ifdef GLFWPP_SSE2
+            _simd{true}
+#else
+            _simd{false}
+#endif
+        {
+            _ramp.red = _values.data();
+            _ramp.green = _values.data() + size_;
+            _ramp.blue = _values.data() + 2 * size_;
+            _ramp.size = static_cast<unsigned int>(size_);
+        }
+
+        // Uses the ramp size of `monitor_`
+        explicit GammaRampBuilder(Monitor monitor_) :
+            GammaRampBuilder{detail::gammaRampSize(monitor_)}
+        {
+        }
+
+        GammaRampBuilder(const GammaRampBuilder&) = delete;
+        GammaRampBuilder& operator=(const GammaRampBuilder&) = delete;
+
+        void setSimdEnabled(bool enabled_) noexcept
+        {
+#ifdef GLFWPP_SSE2
+            _simd = enabled_;
+#else
+            (void)enabled_;
+#endif
+        }
+
+        [[nodiscard]] bool getSimdEnabled() const noexcept
+        {
+            return _simd;
+        }
+
+        [[nodiscard]] std::size_t getSize() const noexcept
+        {
+            return _ramp.size;
+        }
+
+        // The returned ramp stays valid until the next build
+        const GammaRamp& build(const GammaCurve& curve_)
+        {
+            detail::fillGammaRamp(curve_, _simd, _ramp.size, _ramp.red, _ramp.green, _ramp.blue);
+            return _ramp;
+        }
+
+        [[nodiscard]] const GammaRamp& getRamp() const noexcept
+        {
+            return _ramp;
+        }
+
+        void apply(Monitor monitor_) const
+        {
+            monitor_.setGammaRamp(_ramp);
+        }
+    };
+
+    // Fades the gamma ramp of a monitor from one curve to another. All steps
+    // are precomputed by start(); update() applies the ramp of the current
+    // time only if it differs from the one applied last, so a slow fade does
+    // not set the same quantized ramp over and over.
+    class GammaTransition
+    {
+    private:
+        Monitor _monitor;
+        std::size_t _size;
+        std::size_t _stepCount;
+        std::vector<unsigned short> _values;  // Red, green and blue of every step
+        std::vector<std::size_t> _distinct;  // First step with the same ramp as each step
+        std::size_t _applied;
+        double _startTime;
+        double _duration;
+        std::size_t _appliedCount;
+        std::size_t _skippedCount;
+        bool _simd;
+
+        static constexpr std::size_t _none = ~std::size_t{0};
+
+        [[nodiscard]] const unsigned short* _step(std::size_t step_) const noexcept
+        {
+            return _values.data() + step_ * 3 * _size;
+        }
+
+    public:
+        explicit GammaTransition(Monitor monitor_) :
+            _monitor{monitor_},
+            _size{detail::gammaRampSize(monitor_)},
+            _stepCount{0},
+            _values{},
+            _distinct{},
+            _applied{_none},
+            _startTime{0},
+            _duration{0},
+            _appliedCount{0},
+            _skippedCount{0},
+#ifdef GLFWPP_SSE2
+            _simd{true}
+#else
+            _simd{false}
+#endif
+        {
+        }
+
+        GammaTransition(const GammaTransition&) = delete;
+        GammaTransition& operator=(const GammaTransition&) = delete;
+
+        void setSimdEnabled(bool enabled_) noexcept
+        {
+#ifdef GLFWPP_SSE2
+            _simd = enabled_;
+#else
+            (void)enabled_;
+#endif
+        }
+
+        // Precomputes `stepCount_` + 1 ramps from `from_` to `to_` (the color
+        // temperature is interpolated in mired) to be shown over `duration_`
+        // seconds from `startTime_` on
+        void start(const GammaCurve& from_, const GammaCurve& to_, double duration_, std::size_t stepCount_ = 64, double startTime_ = getTime())
+        {
+            _stepCount = std::max<std::size_t>(stepCount_, 1);
+            _values.resize((_stepCount + 1) * 3 * _size);
+            _distinct.resize(_stepCount + 1);
+
+            const float fromMired = 1e6f / std::max(from_.temperature, 1.0f);
+            const float toMired = 1e6f / std::max(to_.temperature, 1.0f);
+            for(std::size_t step = 0; step <= _stepCount; ++step)
+            {
+                const float t = static_cast<float>(step) / static_cast<float>(_stepCount);
+                GammaCurve curve;
+                curve.gamma = from_.gamma + (to_.gamma - from_.gamma) * t;
+                curve.brightness = from_.brightness + (to_.brightness - from_.brightness) * t;
+                curve.contrast = from_.contrast + (to_.contrast - from_.contrast) * t;
+                curve.temperature = 1e6f / (fromMired + (toMired - fromMired) * t);
+
+                unsigned short* red = _values.data() + step * 3 * _size;
+                detail::fillGammaRamp(curve, _simd, _size, red, red + _size, red + 2 * _size);
+
+                const bool same = step > 0 && std::memcmp(red, _step(_distinct[step - 1]), 3 * _size * sizeof(unsigned short)) == 0;
+                _distinct[step] = same ? _distinct[step - 1] : step;
+            }
+
+            _applied = _none;
+            _startTime = startTime_;
+            _duration = duration_;
+        }
+
+        // Applies the ramp of `time_` if it changed. Returns true if a ramp was applied.
+        bool update(double time_ = getTime())
+        {
+            if(!_stepCount)
+            {
+                return false;
+            }
+
+            const double progress = _duration > 0 ? std::clamp((time_ - _startTime) / _duration, 0.0, 1.0) : 1.0;
+            const std::size_t step = _distinct[static_cast<std::size_t>(progress * static_cast<double>(_stepCount) + 0.5)];
+            if(step == _applied)
+            {
+                ++_skippedCount;
+                return false;
+            }
+
+            GammaRamp ramp{};
+            ramp.red = const_cast<unsigned short*>(_step(step));
+            ramp.green = ramp.red + _size;
+            ramp.blue = ramp.red + 2 * _size;
+            ramp.size = static_cast<unsigned int>(_size);
+            _monitor.setGammaRamp(ramp);
+            _applied = step;
+            ++_appliedCount;
+            return true;
+        }
+
+        // True once the final ramp has been applied
+        [[nodiscard]] bool isFinished() const noexcept
+        {
+            return _stepCount && _applied == _distinct[_stepCount];
+        }
+
+        [[nodiscard]] std::size_t getStepCount() const noexcept
+        {
+            return _stepCount;
+        }
+
+        // Number of steps of the current transition with a ramp of their own
+        [[nodiscard]] std::size_t getDistinctStepCount() const noexcept
+        {
+            std::size_t count = 0;
+            for(std::size_t step = 0; step <= _stepCount && _stepCount; ++step)
+            {
+                count += _distinct[step] == step;
+            }
+            return count;
+        }
+
+        [[nodiscard]] std::size_t getAppliedCount() const noexcept
+        {
+            return _appliedCount;
+        }
+
+        // Updates that did not set a ramp because it had not changed
+        [[nodiscard]] std::size_t getSkippedCount() const noexcept
+        {
+            return _skippedCount;
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_GAMMA_RAMP_H
@@ -5,10 +5,14 @@
 
 #include <GLFW/glfw3.h>
 
+#include "basic_window.h"
 #include "error.h"
 #include "event.h"
+#include "fake_clock.h"
+#include "input_channel.h"
 #include "joystick.h"
 #include "monitor.h"
+#include "profiling.h"
 #include "version.h"
 #include "window.h"
 
@@ -56,12 +60,19 @@ namespace glfw
 
         inline void monitorCallback(GLFWmonitor* monitor_, int eventType_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::ProfilingData::monitorSlot);
+            detail::stampEvent();
+            detail::monitorHooks(Monitor{monitor_}, MonitorEventType{eventType_});
             monitorEvent(Monitor{monitor_}, MonitorEventType{eventType_});
         }
 
         inline void joystickCallback(int jid_, int eventType_)
         {
-            joystickEvent(Joystick{static_cast<decltype(Joystick::Joystick1)>(jid_)}, static_cast<JoystickEvent>(eventType_));
+            GLFWPP_PROFILE_CALLBACK(detail::ProfilingData::joystickSlot);
+            detail::stampEvent();
+            const Joystick joystick{static_cast<decltype(Joystick::Joystick1)>(jid_)};
+            detail::joystickHooks(joystick, static_cast<JoystickEvent>(eventType_));
+            joystickEvent(joystick, static_cast<JoystickEvent>(eventType_));
         }
     }  // namespace impl
 
@@ -189,21 +200,38 @@ namespace glfw
 
     [[nodiscard]] inline double getTime()
     {
+        if(detail::fakeClock)
+        {
+            return detail::fakeClock->getTime();
+        }
         return glfwGetTime();
     }
 
     inline void setTime(double time_)
     {
+        if(detail::fakeClock)
+        {
+            detail::fakeClock->setTime(time_);
+            return;
+        }
         glfwSetTime(time_);
     }
 
     [[nodiscard]] inline uint64_t getTimerValue()
     {
+        if(detail::fakeClock)
+        {
+            return detail::fakeClock->getTimerValue();
+        }
         return glfwGetTimerValue();
     }
 
     [[nodiscard]] inline uint64_t getTimerFrequency()
     {
+        if(detail::fakeClock)
+        {
+            return detail::fakeClock->getTimerFrequency();
+        }
         return glfwGetTimerFrequency();
     }
 }  // namespace glfw
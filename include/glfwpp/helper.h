@@ -1,7 +1,19 @@
 #ifndef GLFWPP_HELPER_H
 #define GLFWPP_HELPER_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+// Defined when SSE2 intrinsics are available, unless GLFWPP_NO_SIMD is
+// defined. Headers with SSE2 kernels include <emmintrin.h> themselves.
+#if !defined(GLFWPP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define GLFWPP_SSE2
+#endif
 
 #define GLFWPP_ENUM_FLAGS_OPERATORS(Enum)                                                                       \
     inline std::underlying_type_t<Enum> operator~(Enum lhs)                                                     \
@@ -66,7 +78,267 @@ namespace glfw
                 return _ptr;
             }
         };
+
+        // Bump allocator whose blocks are kept across resets, so that after
+        // warming up it serves all allocations without touching the heap
+        class FrameArena
+        {
+        private:
+            static constexpr std::size_t _blockSize = 16 * 1024;
+
+            struct Block
+            {
+                std::unique_ptr<unsigned char[]> data;
+                std::size_t size;
+            };
+            std::vector<Block> _blocks;
+            std::size_t _block = 0;
+            std::size_t _offset = 0;
+
+        public:
+            [[nodiscard]] void* allocate(std::size_t size_, std::size_t alignment_)
+            {
+                for(; _block < _blocks.size(); ++_block, _offset = 0)
+                {
+                    const std::size_t offset = (_offset + alignment_ - 1) & ~(alignment_ - 1);
+                    if(offset + size_ <= _blocks[_block].size)
+                    {
+                        _offset = offset + size_;
+                        return _blocks[_block].data.get() + offset;
+                    }
+                }
+
+                const std::size_t blockSize = size_ > _blockSize ? size_ : _blockSize;
+                _blocks.push_back({std::make_unique<unsigned char[]>(blockSize), blockSize});
+                _offset = size_;
+                return _blocks.back().data.get();
+            }
+
+            template<typename T>
+            [[nodiscard]] T* allocateArray(std::size_t count_)
+            {
+                return static_cast<T*>(allocate(count_ * sizeof(T), alignof(T)));
+            }
+
+            [[nodiscard]] const char* copyString(const char* string_)
+            {
+                const std::size_t size = std::strlen(string_) + 1;
+                return static_cast<const char*>(std::memcpy(allocate(size, 1), string_, size));
+            }
+
+            void reset() noexcept
+            {
+                _block = 0;
+                _offset = 0;
+            }
+        };
+
+        // Index of the lowest set bit, `value_` must not be zero
+        [[nodiscard]] inline unsigned countTrailingZeros(std::uint64_t value_) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(value_));
+#else
+            unsigned count = 0;
+            while(!(value_ & 1))
+            {
+                value_ >>= 1;
+                ++count;
+            }
+            return count;
+#endif
+        }
+
+        template<typename... Args>
+        class HookList;
+
+        // Internal handler that is linked into a HookList while attached.
+        // Library objects use hooks instead of Event subscriptions, so they
+        // do not take up the subscriber slots of the public events and any
+        // number of them can exist.
+        template<typename... Args>
+        class Hook
+        {
+        public:
+            using FunctionT = void (*)(void*, Args...);
+
+        private:
+            HookList<Args...>* _list = nullptr;
+            Hook* _previous = nullptr;
+            Hook* _next = nullptr;
+            FunctionT _function = nullptr;
+            void* _context = nullptr;
+
+            friend class HookList<Args...>;
+
+        public:
+            constexpr Hook() noexcept = default;
+
+            Hook(HookList<Args...>& list_, FunctionT function_, void* context_) noexcept
+            {
+                attach(list_, function_, context_);
+            }
+
+            Hook(const Hook&) = delete;
+            Hook& operator=(const Hook&) = delete;
+
+            ~Hook() noexcept
+            {
+                reset();
+            }
+
+            // Calls `function_(context_, args...)` whenever the list is invoked
+            void attach(HookList<Args...>& list_, FunctionT function_, void* context_) noexcept
+            {
+                reset();
+                _function = function_;
+                _context = context_;
+                list_._link(*this);
+            }
+
+            void reset() noexcept
+            {
+                if(_list)
+                {
+                    _list->_unlink(*this);
+                }
+            }
+
+            [[nodiscard]] bool isActive() const noexcept
+            {
+                return _list;
+            }
+        };
+
+        // Intrusive list of hooks, invoked in the order they were attached.
+        // Hooks may be attached and reset while the list is being invoked.
+        template<typename... Args>
+        class HookList
+        {
+        private:
+            // Next hook of every invocation in progress, innermost first
+            struct Cursor
+            {
+                Hook<Args...>* next;
+                Cursor* outer;
+            };
+
+            Hook<Args...>* _first = nullptr;
+            Hook<Args...>* _last = nullptr;
+            Cursor* _cursors = nullptr;
+
+            friend class Hook<Args...>;
+
+            void _link(Hook<Args...>& hook_) noexcept
+            {
+                hook_._list = this;
+                hook_._previous = _last;
+                hook_._next = nullptr;
+                (_last ? _last->_next : _first) = &hook_;
+                _last = &hook_;
+            }
+
+            void _unlink(Hook<Args...>& hook_) noexcept
+            {
+                for(Cursor* cursor = _cursors; cursor; cursor = cursor->outer)
+                {
+                    if(cursor->next == &hook_)
+                    {
+                        cursor->next = hook_._next;
+                    }
+                }
+                (hook_._previous ? hook_._previous->_next : _first) = hook_._next;
+                (hook_._next ? hook_._next->_previous : _last) = hook_._previous;
+                hook_._list = nullptr;
+                hook_._previous = nullptr;
+                hook_._next = nullptr;
+            }
+
+        public:
+            constexpr HookList() noexcept = default;
+
+            HookList(const HookList&) = delete;
+            HookList& operator=(const HookList&) = delete;
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return !_first;
+            }
+
+            void operator()(Args... args_)
+            {
+                struct Invocation
+                {
+                    HookList& list;
+                    Cursor cursor;
+
+                    ~Invocation() noexcept
+                    {
+                        list._cursors = cursor.outer;
+                    }
+                } invocation{*this, {_first, _cursors}};
+                _cursors = &invocation.cursor;
+
+                while(Hook<Args...>* hook = invocation.cursor.next)
+                {
+                    invocation.cursor.next = hook->_next;
+                    hook->_function(hook->_context, args_...);
+                }
+            }
+        };
     }  // namespace detail
+
+    // Non-owning view of an array owned by GLFW or by another object
+    template<typename T>
+    class ArrayView
+    {
+    private:
+        const T* _data;
+        std::size_t _size;
+
+    public:
+        constexpr ArrayView() noexcept :
+            _data{},
+            _size{}
+        {
+        }
+
+        constexpr ArrayView(const T* data_, std::size_t size_) noexcept :
+            _data{data_},
+            _size{size_}
+        {
+        }
+
+        [[nodiscard]] constexpr const T* begin() const noexcept
+        {
+            return _data;
+        }
+
+        [[nodiscard]] constexpr const T* end() const noexcept
+        {
+            return _data + _size;
+        }
+
+        [[nodiscard]] constexpr const T* data() const noexcept
+        {
+            return _data;
+        }
+
+        [[nodiscard]] constexpr std::size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        [[nodiscard]] constexpr const T& operator[](std::size_t index_) const noexcept
+        {
+            return _data[index_];
+        }
+    };
 }  // namespace glfw
 
 #endif  //GLFWPP_HELPER_H
@@ -0,0 +1,169 @@
+#ifndef GLFWPP_INPUT_CHANNEL_H
+#define GLFWPP_INPUT_CHANNEL_H
+
+#include "event.h"
+#include "window.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace glfw
+{
+    // Lock-free single-producer/single-consumer ring of window events.
+    // The producer is the thread calling pollEvents (the main thread), the
+    // consumer may be any other single thread. When the ring is full new
+    // events are dropped and counted instead of blocking the main thread.
+    class InputChannel
+    {
+    private:
+        static constexpr std::size_t _cacheLineSize = 64;
+
+        std::unique_ptr<WindowEvent[]> _buffer;
+        std::size_t _mask;
+
+        // Written by the consumer
+        alignas(_cacheLineSize) std::atomic<std::size_t> _head;
+        std::size_t _cachedTail;
+
+        // Written by the producer
+        alignas(_cacheLineSize) std::atomic<std::size_t> _tail;
+        std::size_t _cachedHead;
+        std::atomic<std::uint64_t> _pushedCount;
+        std::atomic<std::uint64_t> _overflowCount;
+        std::atomic<std::size_t> _highWaterMark;
+
+        [[nodiscard]] static std::size_t _roundUpToPowerOfTwo(std::size_t value_)
+        {
+            std::size_t result = 1;
+            while(result < value_)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+    public:
+        explicit InputChannel(std::size_t capacity_ = 4096) :
+            _buffer{std::make_unique<WindowEvent[]>(_roundUpToPowerOfTwo(capacity_))},
+            _mask{_roundUpToPowerOfTwo(capacity_) - 1},
+            _head{0},
+            _cachedTail{0},
+            _tail{0},
+            _cachedHead{0},
+            _pushedCount{0},
+            _overflowCount{0},
+            _highWaterMark{0}
+        {
+        }
+
+        InputChannel(const InputChannel&) = delete;
+        InputChannel& operator=(const InputChannel&) = delete;
+
+        // Producer side. Returns false and counts an overflow if the ring is full.
+        bool tryPush(const WindowEvent& event_) noexcept
+        {
+            const std::size_t tail = _tail.load(std::memory_order_relaxed);
+            if(tail - _cachedHead > _mask)
+            {
+                _cachedHead = _head.load(std::memory_order_acquire);
+                if(tail - _cachedHead > _mask)
+                {
+                    _overflowCount.store(_overflowCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            _buffer[tail & _mask] = event_;
+            _tail.store(tail + 1, std::memory_order_release);
+
+            _pushedCount.store(_pushedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            const std::size_t used = tail + 1 - _cachedHead;
+            if(used > _highWaterMark.load(std::memory_order_relaxed))
+            {
+                _highWaterMark.store(used, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        // Consumer side. Returns false if there is no event.
+        bool tryPop(WindowEvent& event_) noexcept
+        {
+            const std::size_t head = _head.load(std::memory_order_relaxed);
+            if(head == _cachedTail)
+            {
+                _cachedTail = _tail.load(std::memory_order_acquire);
+                if(head == _cachedTail)
+                {
+                    return false;
+                }
+            }
+
+            event_ = _buffer[head & _mask];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side. Calls `handler_` for every event available and
+        // publishes the freed space once. Returns the number of events.
+        template<typename HandlerT>
+        std::size_t drain(HandlerT&& handler_)
+        {
+            const std::size_t head = _head.load(std::memory_order_relaxed);
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            for(std::size_t i = head; i != _cachedTail; ++i)
+            {
+                handler_(static_cast<const WindowEvent&>(_buffer[i & _mask]));
+            }
+            _head.store(_cachedTail, std::memory_order_release);
+            return _cachedTail - head;
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return _mask + 1;
+        }
+
+        // Approximate when called concurrently with the other side
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+
+        // Lets the producer back off (e.g. skip optional events) before the ring overflows
+        [[nodiscard]] float getFillLevel() const noexcept
+        {
+            return static_cast<float>(size()) / static_cast<float>(capacity());
+        }
+
+        [[nodiscard]] std::uint64_t getPushedCount() const noexcept
+        {
+            return _pushedCount.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::uint64_t getOverflowCount() const noexcept
+        {
+            return _overflowCount.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::size_t getHighWaterMark() const noexcept
+        {
+            return _highWaterMark.load(std::memory_order_relaxed);
+        }
+
+        // Feeds all events of `window_` except drops into the channel until
+        // the returned subscription is destroyed. Dropped paths are owned by
+        // GLFW and cannot outlive the callback, so they are not forwarded.
+        [[nodiscard]] Subscription attach(Window& window_)
+        {
+            return window_.anyEvent.subscribe([this](const WindowEvent& event_) {
+                if(event_.type != WindowEventType::Drop)
+                {
+                    tryPush(event_);
+                }
+            });
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_INPUT_CHANNEL_H
@@ -3,6 +3,8 @@
 
 #include "helper.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 namespace glfw
@@ -72,6 +74,29 @@ namespace glfw
         Disconnected = GLFW_DISCONNECTED
     };
 
+    // State of all joysticks filled by Joystick::pollAll. The arrays are
+    // indexed by joystick last, so one axis of all joysticks is contiguous.
+    // Inputs beyond the capacities below are not included; entries of
+    // joysticks that are not present and beyond the counts are zero.
+    struct JoystickSnapshot
+    {
+        static constexpr std::size_t joystickCount = GLFW_JOYSTICK_LAST + 1;
+        static constexpr std::size_t maxAxes = 16;
+        static constexpr std::size_t maxButtons = 64;
+        static constexpr std::size_t maxHats = 4;
+
+        std::uint32_t presentMask;  // Bit i is set if joystick i is connected
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        std::uint32_t gamepadMask;  // Bit i is set if joystick i has a gamepad mapping
+#endif
+        std::uint8_t axisCount[joystickCount];
+        std::uint8_t buttonCount[joystickCount];
+        std::uint8_t hatCount[joystickCount];
+        float axes[maxAxes][joystickCount];
+        std::uint64_t buttons[joystickCount];  // Bit i is set while button i is pressed
+        std::uint8_t hats[maxHats][joystickCount];  // JoystickHatStateBit values
+    };
+
     class Joystick
     {
     public:
@@ -157,6 +182,85 @@ namespace glfw
         }
 #endif
 
+        // The views below point into arrays owned by GLFW. They stay valid
+        // until the joystick is disconnected or GLFW is terminated; their
+        // contents are updated whenever the joystick is polled.
+        [[nodiscard]] ArrayView<float> getAxesView() const
+        {
+            int count;
+            const float* pAxes = glfwGetJoystickAxes(_id, &count);
+            return {pAxes, pAxes ? static_cast<std::size_t>(count) : 0};
+        }
+
+        // GLFW_PRESS or GLFW_RELEASE per button
+        [[nodiscard]] ArrayView<unsigned char> getButtonsView() const
+        {
+            int count;
+            const unsigned char* pButtons = glfwGetJoystickButtons(_id, &count);
+            return {pButtons, pButtons ? static_cast<std::size_t>(count) : 0};
+        }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        // JoystickHatStateBit values per hat
+        [[nodiscard]] ArrayView<unsigned char> getHatsView() const
+        {
+            int count;
+            const unsigned char* pHats = glfwGetJoystickHats(_id, &count);
+            return {pHats, pHats ? static_cast<std::size_t>(count) : 0};
+        }
+#endif
+
+        // Fills `snapshot_` with the state of every joystick without allocating
+        static void pollAll(JoystickSnapshot& snapshot_)
+        {
+            snapshot_ = {};
+            for(std::size_t jid = 0; jid < JoystickSnapshot::joystickCount; ++jid)
+            {
+                int axisCount;
+                const float* pAxes = glfwGetJoystickAxes(static_cast<int>(jid), &axisCount);
+                if(!pAxes)
+                {
+                    continue;
+                }
+                snapshot_.presentMask |= std::uint32_t{1} << jid;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                if(glfwJoystickIsGamepad(static_cast<int>(jid)))
+                {
+                    snapshot_.gamepadMask |= std::uint32_t{1} << jid;
+                }
+#endif
+
+                axisCount = std::min(axisCount, static_cast<int>(JoystickSnapshot::maxAxes));
+                snapshot_.axisCount[jid] = static_cast<std::uint8_t>(axisCount);
+                for(int i = 0; i < axisCount; ++i)
+                {
+                    snapshot_.axes[i][jid] = pAxes[i];
+                }
+
+                int buttonCount = 0;
+                const unsigned char* pButtons = glfwGetJoystickButtons(static_cast<int>(jid), &buttonCount);
+                buttonCount = pButtons ? std::min(buttonCount, static_cast<int>(JoystickSnapshot::maxButtons)) : 0;
+                snapshot_.buttonCount[jid] = static_cast<std::uint8_t>(buttonCount);
+                std::uint64_t buttons = 0;
+                for(int i = 0; i < buttonCount; ++i)
+                {
+                    buttons |= std::uint64_t{pButtons[i] != GLFW_RELEASE} << i;
+                }
+                snapshot_.buttons[jid] = buttons;
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                int hatCount = 0;
+                const unsigned char* pHats = glfwGetJoystickHats(static_cast<int>(jid), &hatCount);
+                hatCount = pHats ? std::min(hatCount, static_cast<int>(JoystickSnapshot::maxHats)) : 0;
+                snapshot_.hatCount[jid] = static_cast<std::uint8_t>(hatCount);
+                for(int i = 0; i < hatCount; ++i)
+                {
+                    snapshot_.hats[i][jid] = pHats[i];
+                }
+#endif
+            }
+        }
+
         [[nodiscard]] const char* getName() const
         {
             return glfwGetJoystickName(_id);
@@ -225,6 +329,12 @@ namespace glfw
 
     inline Event<Joystick, JoystickEvent> joystickEvent;
 
+    namespace detail
+    {
+        // Invoked before joystickEvent, for library objects
+        inline HookList<Joystick, JoystickEvent> joystickHooks;
+    }  // namespace detail
+
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
     [[nodiscard]] inline bool updateGamepadMappings(const char* string_)
     {
@@ -0,0 +1,268 @@
+#ifndef GLFWPP_JOYSTICK_DIFF_H
+#define GLFWPP_JOYSTICK_DIFF_H
+
+#include "event.h"
+#include "gamepad_filter.h"
+#include "helper.h"
+#include "joystick.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#ifdef GLFWPP_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace glfw
+{
+    namespace detail
+    {
+        constexpr std::size_t joystickLanes = JoystickSnapshot::joystickCount;
+        static_assert(joystickLanes == 16, "The joystick diff kernels process 16 joysticks at once");
+
+        // Bit i is set if lane i of `current_` differs from `reported_` by more than `threshold_`
+        [[nodiscard]] inline std::uint32_t axisChangeMask(const float* current_, const float* reported_, float threshold_) noexcept
+        {
+#ifdef GLFWPP_SSE2
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 threshold = _mm_set1_ps(threshold_);
+            std::uint32_t mask = 0;
+            for(std::size_t lane = 0; lane < joystickLanes; lane += 4)
+            {
+                const __m128 difference = _mm_sub_ps(_mm_loadu_ps(current_ + lane), _mm_loadu_ps(reported_ + lane));
+                const __m128 changed = _mm_cmpgt_ps(_mm_andnot_ps(signMask, difference), threshold);
+                mask |= static_cast<std::uint32_t>(_mm_movemask_ps(changed)) << lane;
+            }
+            return mask;
+#else
+            std::uint32_t mask = 0;
+            for(std::size_t lane = 0; lane < joystickLanes; ++lane)
+            {
+                mask |= static_cast<std::uint32_t>(std::fabs(current_[lane] - reported_[lane]) > threshold_) << lane;
+            }
+            return mask;
+#endif
+        }
+
+        // Bit i is set if byte i of `current_` and `previous_` differ
+        [[nodiscard]] inline std::uint32_t byteChangeMask(const std::uint8_t* current_, const std::uint8_t* previous_) noexcept
+        {
+#ifdef GLFWPP_SSE2
+            const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current_));
+            const __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous_));
+            return ~static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(current, previous))) & 0xFFFF;
+#else
+            std::uint32_t mask = 0;
+            for(std::size_t lane = 0; lane < joystickLanes; ++lane)
+            {
+                mask |= static_cast<std::uint32_t>(current_[lane] != previous_[lane]) << lane;
+            }
+            return mask;
+#endif
+        }
+
+        [[nodiscard]] inline Joystick joystickOf(std::size_t jid_) noexcept
+        {
+            return Joystick{static_cast<decltype(Joystick::Joystick1)>(jid_)};
+        }
+    }  // namespace detail
+
+    // Turns consecutive joystick and gamepad snapshots into button, axis and
+    // hat events. Buttons and hats are reported on every change, axes once
+    // they moved by more than the threshold from the last reported value.
+    // Joysticks that connect or disconnect are compared against a released,
+    // centered state, so no button stays pressed after a disconnect.
+    //
+    // By default the diff polls at the end of every pollEvents/waitEvents.
+    // Gamepad state is only read while the gamepad events have handlers.
+    // When reading resumes, the gamepad state is taken over without events,
+    // since the state last seen may be arbitrarily old.
+    class JoystickDiff
+    {
+    public:
+        Event<Joystick, int, bool> buttonEvent;  // Button index, pressed
+        Event<Joystick, int, float> axisEvent;  // Axis index, value
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        Event<Joystick, int, JoystickHatStateBit> hatEvent;  // Hat index, state
+        Event<Joystick, GamepadButton, bool> gamepadButtonEvent;
+        Event<Joystick, GamepadAxis, float> gamepadAxisEvent;
+#endif
+
+    private:
+        float _axisThreshold;
+        std::size_t _axisRows;  // Axes that may be non-zero in the previous snapshot
+        std::uint64_t _buttons[detail::joystickLanes];
+        float _axes[JoystickSnapshot::maxAxes][detail::joystickLanes];
+        std::uint8_t _hats[JoystickSnapshot::maxHats][detail::joystickLanes];
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        std::uint16_t _gamepadButtons[GamepadBatch::gamepadCount];
+        float _gamepadAxes[GamepadBatch::axisCount][GamepadBatch::gamepadCount];
+        GamepadBatch _gamepadSnapshot;
+        bool _gamepadsStale;  // Gamepads were not polled by the last update
+#endif
+        JoystickSnapshot _snapshot;
+        detail::Hook<> _pollHook;
+
+        static void _onPoll(void* diff_)
+        {
+            static_cast<JoystickDiff*>(diff_)->update();
+        }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        // Takes over `batch_` as the previous gamepad state without emitting events
+        void _resyncGamepads(const GamepadBatch& batch_) noexcept
+        {
+            std::copy(std::begin(batch_.buttons), std::end(batch_.buttons), _gamepadButtons);
+            for(std::size_t axis = 0; axis < GamepadBatch::axisCount; ++axis)
+            {
+                std::copy(std::begin(batch_.axes[axis]), std::end(batch_.axes[axis]), _gamepadAxes[axis]);
+            }
+        }
+#endif
+
+    public:
+        explicit JoystickDiff(float axisThreshold_ = 0.01f, bool updateOnPoll_ = true) :
+            buttonEvent{},
+            axisEvent{},
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            hatEvent{},
+            gamepadButtonEvent{},
+            gamepadAxisEvent{},
+#endif
+            _axisThreshold{axisThreshold_},
+            _axisRows{0},
+            _buttons{},
+            _axes{},
+            _hats{},
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            _gamepadButtons{},
+            _gamepadAxes{},
+            _gamepadSnapshot{},
+            _gamepadsStale{false},
+#endif
+            _snapshot{},
+            _pollHook{}
+        {
+            if(updateOnPoll_)
+            {
+                _pollHook.attach(detail::postPollHooks, &JoystickDiff::_onPoll, this);
+            }
+        }
+
+        JoystickDiff(const JoystickDiff&) = delete;
+        JoystickDiff& operator=(const JoystickDiff&) = delete;
+
+        void setAxisThreshold(float threshold_) noexcept
+        {
+            _axisThreshold = threshold_;
+        }
+
+        [[nodiscard]] float getAxisThreshold() const noexcept
+        {
+            return _axisThreshold;
+        }
+
+        // Polls all joysticks (and gamepads, if their events have handlers) and emits the changes
+        void update()
+        {
+            Joystick::pollAll(_snapshot);
+            process(_snapshot);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            if(!gamepadButtonEvent.hasHandlers() && !gamepadAxisEvent.hasHandlers())
+            {
+                _gamepadsStale = true;
+                return;
+            }
+
+            pollGamepads(_gamepadSnapshot, _snapshot.gamepadMask);
+            if(std::exchange(_gamepadsStale, false))
+            {
+                _resyncGamepads(_gamepadSnapshot);
+            }
+            else
+            {
+                process(_gamepadSnapshot);
+            }
+#endif
+        }
+
+        // Emits the changes from the previously processed joystick snapshot to `snapshot_`
+        void process(const JoystickSnapshot& snapshot_)
+        {
+            for(std::size_t jid = 0; jid < detail::joystickLanes; ++jid)
+            {
+                const std::uint64_t buttons = snapshot_.buttons[jid];
+                for(std::uint64_t changed = buttons ^ _buttons[jid]; changed; changed &= changed - 1)
+                {
+                    const unsigned button = detail::countTrailingZeros(changed);
+                    _buttons[jid] ^= std::uint64_t{1} << button;
+                    buttonEvent(detail::joystickOf(jid), static_cast<int>(button), (buttons >> button & 1) != 0);
+                }
+            }
+
+            std::size_t axisRows = 0;
+            for(std::uint8_t axisCount : snapshot_.axisCount)
+            {
+                axisRows = std::max<std::size_t>(axisRows, axisCount);
+            }
+            std::swap(axisRows, _axisRows);
+            axisRows = std::max(axisRows, _axisRows);
+
+            for(std::size_t axis = 0; axis < axisRows; ++axis)
+            {
+                for(std::uint32_t changed = detail::axisChangeMask(snapshot_.axes[axis], _axes[axis], _axisThreshold); changed; changed &= changed - 1)
+                {
+                    const unsigned jid = detail::countTrailingZeros(changed);
+                    _axes[axis][jid] = snapshot_.axes[axis][jid];
+                    axisEvent(detail::joystickOf(jid), static_cast<int>(axis), _axes[axis][jid]);
+                }
+            }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            for(std::size_t hat = 0; hat < JoystickSnapshot::maxHats; ++hat)
+            {
+                for(std::uint32_t changed = detail::byteChangeMask(snapshot_.hats[hat], _hats[hat]); changed; changed &= changed - 1)
+                {
+                    const unsigned jid = detail::countTrailingZeros(changed);
+                    _hats[hat][jid] = snapshot_.hats[hat][jid];
+                    hatEvent(detail::joystickOf(jid), static_cast<int>(hat), static_cast<JoystickHatStateBit>(_hats[hat][jid]));
+                }
+            }
+#endif
+        }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        // Emits the changes from the previously processed gamepad batch to
+        // `batch_`, which may also be the output of a GamepadFilter
+        void process(const GamepadBatch& batch_)
+        {
+            for(std::size_t jid = 0; jid < GamepadBatch::gamepadCount; ++jid)
+            {
+                const std::uint16_t buttons = batch_.buttons[jid];
+                for(std::uint64_t changed = buttons ^ _gamepadButtons[jid]; changed; changed &= changed - 1)
+                {
+                    const unsigned button = detail::countTrailingZeros(changed);
+                    _gamepadButtons[jid] ^= static_cast<std::uint16_t>(1 << button);
+                    gamepadButtonEvent(detail::joystickOf(jid), static_cast<GamepadButton>(button), (buttons >> button & 1) != 0);
+                }
+            }
+
+            for(std::size_t axis = 0; axis < GamepadBatch::axisCount; ++axis)
+            {
+                for(std::uint32_t changed = detail::axisChangeMask(batch_.axes[axis], _gamepadAxes[axis], _axisThreshold); changed; changed &= changed - 1)
+                {
+                    const unsigned jid = detail::countTrailingZeros(changed);
+                    _gamepadAxes[axis][jid] = batch_.axes[axis][jid];
+                    gamepadAxisEvent(detail::joystickOf(jid), static_cast<GamepadAxis>(axis), _gamepadAxes[axis][jid]);
+                }
+            }
+        }
+#endif
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_JOYSTICK_DIFF_H
@@ -0,0 +1,133 @@
+#ifndef GLFWPP_JOYSTICK_PUBLISHER_H
+#define GLFWPP_JOYSTICK_PUBLISHER_H
+
+#include "event.h"
+#include "gamepad_filter.h"
+#include "glfwpp.h"
+#include "joystick.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace glfw
+{
+    struct JoystickSample
+    {
+        std::uint64_t sequence;  // 0 until the first sample is published
+        std::uint64_t timestamp;  // Timer value (see getTimerValue) when the sample was taken
+        JoystickSnapshot joysticks;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        GamepadBatch gamepads;  // Unfiltered gamepad state of the joysticks with a mapping
+#endif
+    };
+
+    // Publishes the state of all joysticks from the main thread to one
+    // consumer thread through a wait-free triple buffer. The main thread
+    // samples at the end of every pollEvents/waitEvents (or with publish());
+    // the consumer always gets the newest complete sample and can use the
+    // sequence number and timestamp to detect stale data. There must be a
+    // single consumer thread: acquire() swaps the buffer owned by the
+    // consumer, so threads that read concurrently each need a publisher.
+    class JoystickPublisher
+    {
+    private:
+        static constexpr std::size_t _cacheLineSize = 64;
+        static constexpr std::uint8_t _freshBit = 4;
+        static constexpr std::uint8_t _indexMask = 3;
+
+        std::unique_ptr<JoystickSample[]> _samples;
+
+        // Index of the sample between the threads, with _freshBit set if the
+        // consumer has not seen it yet
+        alignas(_cacheLineSize) std::atomic<std::uint8_t> _middle;
+
+        // Owned by the main thread
+        alignas(_cacheLineSize) std::uint8_t _back;
+        std::uint64_t _sequence;
+        detail::Hook<> _pollHook;
+
+        // Owned by the consumer
+        alignas(_cacheLineSize) std::uint8_t _front;
+
+        static void _onPoll(void* publisher_)
+        {
+            static_cast<JoystickPublisher*>(publisher_)->publish();
+        }
+
+    public:
+        explicit JoystickPublisher(bool publishOnPoll_ = true) :
+            _samples{std::make_unique<JoystickSample[]>(3)},
+            _middle{1},
+            _back{2},
+            _sequence{0},
+            _pollHook{},
+            _front{0}
+        {
+            if(publishOnPoll_)
+            {
+                _pollHook.attach(detail::postPollHooks, &JoystickPublisher::_onPoll, this);
+            }
+        }
+
+        JoystickPublisher(const JoystickPublisher&) = delete;
+        JoystickPublisher& operator=(const JoystickPublisher&) = delete;
+
+        // Main thread. Takes a sample of all joysticks and makes it available to the consumer.
+        void publish()
+        {
+            JoystickSample& sample = _samples[_back];
+            Joystick::pollAll(sample.joysticks);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            pollGamepads(sample.gamepads, sample.joysticks.gamepadMask);
+#endif
+            sample.sequence = ++_sequence;
+            sample.timestamp = getTimerValue();
+
+            _back = _middle.exchange(static_cast<std::uint8_t>(_back | _freshBit), std::memory_order_acq_rel) & _indexMask;
+        }
+
+        // Main thread. Waits for events until getTime() reaches `time_`,
+        // waking up at least every `sampleInterval_` seconds, so joysticks are
+        // sampled more often than frames are rendered.
+        void waitEventsUntil(double time_, double sampleInterval_)
+        {
+            for(double now = getTime(); now < time_; now = getTime())
+            {
+                waitEvents(std::min(sampleInterval_, time_ - now));
+                if(!_pollHook.isActive())
+                {
+                    publish();
+                }
+            }
+        }
+
+        // Consumer thread. Returns the newest published sample, which stays
+        // valid and unchanged until the next call. Not safe to call from more
+        // than one thread.
+        [[nodiscard]] const JoystickSample& acquire() noexcept
+        {
+            if(_middle.load(std::memory_order_relaxed) & _freshBit)
+            {
+                _front = _middle.exchange(_front, std::memory_order_acq_rel) & _indexMask;
+            }
+            return _samples[_front];
+        }
+
+        // Consumer thread. True if acquire() would return a newer sample.
+        [[nodiscard]] bool hasNewSample() const noexcept
+        {
+            return _middle.load(std::memory_order_relaxed) & _freshBit;
+        }
+
+        // Main thread. Number of samples published so far.
+        [[nodiscard]] std::uint64_t getPublishedCount() const noexcept
+        {
+            return _sequence;
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_JOYSTICK_PUBLISHER_H
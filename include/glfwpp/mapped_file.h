@@ -0,0 +1,139 @@
+#ifndef GLFWPP_MAPPED_FILE_H
+#define GLFWPP_MAPPED_FILE_H
+
+#include "error.h"
+#include <cstddef>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+        #define GLFWPP_UNDEF_WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+        #define GLFWPP_UNDEF_NOMINMAX
+    #endif
+    #include <windows.h>
+    #ifdef GLFWPP_UNDEF_WIN32_LEAN_AND_MEAN
+        #undef WIN32_LEAN_AND_MEAN
+        #undef GLFWPP_UNDEF_WIN32_LEAN_AND_MEAN
+    #endif
+    #ifdef GLFWPP_UNDEF_NOMINMAX
+        #undef NOMINMAX
+        #undef GLFWPP_UNDEF_NOMINMAX
+    #endif
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace glfw
+{
+    namespace detail
+    {
+        // Read-only memory mapping of a whole file
+        class MappedFile
+        {
+        private:
+            const unsigned char* _data = nullptr;
+            std::size_t _size = 0;
+
+            void _unmap() noexcept
+            {
+                if(_data)
+                {
+#if defined(_WIN32)
+                    UnmapViewOfFile(_data);
+#else
+                    munmap(const_cast<unsigned char*>(_data), _size);
+#endif
+                }
+                _data = nullptr;
+                _size = 0;
+            }
+
+        public:
+            MappedFile() noexcept = default;
+
+            explicit MappedFile(const char* path_)
+            {
+#if defined(_WIN32)
+                HANDLE file = CreateFileA(path_, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if(file == INVALID_HANDLE_VALUE)
+                {
+                    throw Error("Could not open file");
+                }
+                LARGE_INTEGER size;
+                GetFileSizeEx(file, &size);
+                _size = static_cast<std::size_t>(size.QuadPart);
+                if(_size)
+                {
+                    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if(mapping)
+                    {
+                        _data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                        CloseHandle(mapping);
+                    }
+                }
+                CloseHandle(file);
+#else
+                const int file = open(path_, O_RDONLY);
+                if(file < 0)
+                {
+                    throw Error("Could not open file");
+                }
+                struct stat info;
+                fstat(file, &info);
+                _size = static_cast<std::size_t>(info.st_size);
+                if(_size)
+                {
+                    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+                    _data = data == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(data);
+                }
+                close(file);
+#endif
+                if(_size && !_data)
+                {
+                    throw Error("Could not map file");
+                }
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            MappedFile(MappedFile&& other_) noexcept :
+                _data{std::exchange(other_._data, nullptr)},
+                _size{std::exchange(other_._size, 0)}
+            {
+            }
+
+            MappedFile& operator=(MappedFile&& other_) noexcept
+            {
+                _unmap();
+                _data = std::exchange(other_._data, nullptr);
+                _size = std::exchange(other_._size, 0);
+                return *this;
+            }
+
+            ~MappedFile() noexcept
+            {
+                _unmap();
+            }
+
+            [[nodiscard]] const unsigned char* data() const noexcept
+            {
+                return _data;
+            }
+
+            [[nodiscard]] std::size_t size() const noexcept
+            {
+                return _size;
+            }
+        };
+    }  // namespace detail
+}  // namespace glfw
+
+#endif  //GLFWPP_MAPPED_FILE_H
@@ -150,6 +150,12 @@ namespace glfw
         Disconnected = GLFW_DISCONNECTED
     };
     inline Event<Monitor, MonitorEventType> monitorEvent;
+
+    namespace detail
+    {
+        // Invoked before monitorEvent, for library objects
+        inline HookList<Monitor, MonitorEventType> monitorHooks;
+    }  // namespace detail
 }  // namespace glfw
 
 #endif  //GLFWPP_MONITOR_H
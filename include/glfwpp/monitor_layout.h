@@ -0,0 +1,242 @@
+#ifndef GLFWPP_MONITOR_LAYOUT_H
+#define GLFWPP_MONITOR_LAYOUT_H
+
+#include "monitor.h"
+#include "monitor_registry.h"
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace glfw
+{
+    struct MonitorRect
+    {
+        int xPos, yPos, width, height;
+    };
+
+    struct MonitorOverlap
+    {
+        const MonitorInfo* monitor;  // nullptr if no monitor overlaps
+        float fraction;  // Part of the queried rectangle on the monitor, from 0 to 1
+    };
+
+    // Cached rectangles of all monitors in a MonitorRegistry (which must
+    // outlive the layout) for point, overlap and nearest-monitor queries in
+    // virtual screen coordinates. Monitor bounds are the position and the
+    // size of the current video mode. Point queries go through an index of
+    // vertical slabs, so only the monitors spanning the point's column are
+    // tested. The layout is rebuilt when the registry's generation changes,
+    // i.e. after monitorEvent.
+    class MonitorLayout
+    {
+    private:
+        MonitorRegistry& _registry;
+        std::uint64_t _generation;
+        std::vector<const MonitorInfo*> _monitors;
+        std::vector<MonitorRect> _bounds;
+        std::vector<MonitorRect> _workAreas;
+        std::vector<int> _slabEdges;  // Sorted distinct left and right edges
+        std::vector<std::size_t> _slabOffsets;  // Range of each slab in _slabMonitors
+        std::vector<std::uint32_t> _slabMonitors;
+
+        [[nodiscard]] static bool _contains(const MonitorRect& rect_, int x_, int y_) noexcept
+        {
+            return x_ >= rect_.xPos && x_ < rect_.xPos + rect_.width && y_ >= rect_.yPos && y_ < rect_.yPos + rect_.height;
+        }
+
+        [[nodiscard]] static std::int64_t _overlapArea(const MonitorRect& lhs_, const MonitorRect& rhs_) noexcept
+        {
+            const std::int64_t width = std::min(lhs_.xPos + lhs_.width, rhs_.xPos + rhs_.width) - std::max(lhs_.xPos, rhs_.xPos);
+            const std::int64_t height = std::min(lhs_.yPos + lhs_.height, rhs_.yPos + rhs_.height) - std::max(lhs_.yPos, rhs_.yPos);
+            return width > 0 && height > 0 ? width * height : 0;
+        }
+
+        [[nodiscard]] static std::int64_t _squaredDistance(const MonitorRect& rect_, int x_, int y_) noexcept
+        {
+            const std::int64_t dx = x_ < rect_.xPos ? rect_.xPos - x_ : x_ >= rect_.xPos + rect_.width ? x_ - (rect_.xPos + rect_.width - 1) : 0;
+            const std::int64_t dy = y_ < rect_.yPos ? rect_.yPos - y_ : y_ >= rect_.yPos + rect_.height ? y_ - (rect_.yPos + rect_.height - 1) : 0;
+            return dx * dx + dy * dy;
+        }
+
+        void _build()
+        {
+            _monitors.clear();
+            _bounds.clear();
+            _workAreas.clear();
+            _slabEdges.clear();
+            _slabOffsets.clear();
+            _slabMonitors.clear();
+
+            for(const MonitorInfo& info : _registry.getMonitors())
+            {
+                const MonitorRect bounds{info.xPos, info.yPos, info.currentMode.width, info.currentMode.height};
+                _monitors.push_back(&info);
+                _bounds.push_back(bounds);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                _workAreas.push_back({info.workAreaXPos, info.workAreaYPos, info.workAreaWidth, info.workAreaHeight});
+#else
+                _workAreas.push_back(bounds);
+#endif
+                _slabEdges.push_back(bounds.xPos);
+                _slabEdges.push_back(bounds.xPos + bounds.width);
+            }
+            std::sort(_slabEdges.begin(), _slabEdges.end());
+            _slabEdges.erase(std::unique(_slabEdges.begin(), _slabEdges.end()), _slabEdges.end());
+
+            for(std::size_t slab = 0; slab + 1 < _slabEdges.size(); ++slab)
+            {
+                _slabOffsets.push_back(_slabMonitors.size());
+                for(std::size_t i = 0; i < _bounds.size(); ++i)
+                {
+                    if(_bounds[i].xPos <= _slabEdges[slab] && _bounds[i].xPos + _bounds[i].width >= _slabEdges[slab + 1])
+                    {
+                        _slabMonitors.push_back(static_cast<std::uint32_t>(i));
+                    }
+                }
+            }
+            _slabOffsets.push_back(_slabMonitors.size());
+
+            _generation = _registry.getGeneration();
+        }
+
+        void _update()
+        {
+            if(_generation != _registry.getGeneration())
+            {
+                _build();
+            }
+        }
+
+        [[nodiscard]] const std::vector<MonitorRect>& _rects(bool workArea_) const noexcept
+        {
+            return workArea_ ? _workAreas : _bounds;
+        }
+
+    public:
+        explicit MonitorLayout(MonitorRegistry& registry_) :
+            _registry{registry_},
+            _generation{0},
+            _monitors{},
+            _bounds{},
+            _workAreas{},
+            _slabEdges{},
+            _slabOffsets{},
+            _slabMonitors{}
+        {
+        }
+
+        MonitorLayout(const MonitorLayout&) = delete;
+        MonitorLayout& operator=(const MonitorLayout&) = delete;
+
+        // Bounds (or work area) of a monitor, empty if it is not connected
+        [[nodiscard]] MonitorRect getRect(Monitor monitor_, bool workArea_ = false)
+        {
+            _update();
+            for(std::size_t i = 0; i < _monitors.size(); ++i)
+            {
+                if(static_cast<GLFWmonitor*>(_monitors[i]->monitor) == static_cast<GLFWmonitor*>(monitor_))
+                {
+                    return _rects(workArea_)[i];
+                }
+            }
+            return {};
+        }
+
+        // Monitor whose bounds (or work area) contain the point, nullptr if none
+        [[nodiscard]] const MonitorInfo* findAt(int x_, int y_, bool workArea_ = false)
+        {
+            _update();
+            const auto edge = std::upper_bound(_slabEdges.begin(), _slabEdges.end(), x_);
+            if(edge == _slabEdges.begin() || edge == _slabEdges.end())
+            {
+                return nullptr;
+            }
+
+            const std::size_t slab = static_cast<std::size_t>(edge - _slabEdges.begin()) - 1;
+            const std::vector<MonitorRect>& rects = _rects(workArea_);
+            for(std::size_t i = _slabOffsets[slab]; i < _slabOffsets[slab + 1]; ++i)
+            {
+                if(_contains(rects[_slabMonitors[i]], x_, y_))
+                {
+                    return _monitors[_slabMonitors[i]];
+                }
+            }
+            return nullptr;
+        }
+
+        // Monitor closest to the point (the containing one if any), nullptr if there are no monitors
+        [[nodiscard]] const MonitorInfo* findNearest(int x_, int y_, bool workArea_ = false)
+        {
+            if(const MonitorInfo* monitor = findAt(x_, y_, workArea_))
+            {
+                return monitor;
+            }
+
+            const std::vector<MonitorRect>& rects = _rects(workArea_);
+            const MonitorInfo* nearest = nullptr;
+            std::int64_t nearestDistance = 0;
+            for(std::size_t i = 0; i < rects.size(); ++i)
+            {
+                const std::int64_t distance = _squaredDistance(rects[i], x_, y_);
+                if(!nearest || distance < nearestDistance)
+                {
+                    nearest = _monitors[i];
+                    nearestDistance = distance;
+                }
+            }
+            return nearest;
+        }
+
+        // Part of `rect_` that lies on `monitor_`, from 0 to 1
+        [[nodiscard]] float getOverlapFraction(Monitor monitor_, const MonitorRect& rect_, bool workArea_ = false)
+        {
+            const std::int64_t area = static_cast<std::int64_t>(rect_.width) * rect_.height;
+            if(area <= 0)
+            {
+                return 0;
+            }
+            return static_cast<float>(_overlapArea(getRect(monitor_, workArea_), rect_)) / static_cast<float>(area);
+        }
+
+        // Monitor that `rect_` overlaps most, e.g. to pick the content scale of a window
+        [[nodiscard]] MonitorOverlap findMostOverlapping(const MonitorRect& rect_, bool workArea_ = false)
+        {
+            _update();
+            const std::int64_t area = static_cast<std::int64_t>(rect_.width) * rect_.height;
+            const std::vector<MonitorRect>& rects = _rects(workArea_);
+            MonitorOverlap best{nullptr, 0};
+            std::int64_t bestArea = 0;
+            for(std::size_t i = 0; i < rects.size(); ++i)
+            {
+                const std::int64_t overlap = _overlapArea(rects[i], rect_);
+                if(overlap > bestArea)
+                {
+                    bestArea = overlap;
+                    best = {_monitors[i], static_cast<float>(overlap) / static_cast<float>(area)};
+                }
+            }
+            return best;
+        }
+
+        // Monitor the window overlaps most, or the one nearest to its center
+        // (with a fraction of 0) if it is on none. Takes the window position
+        // and size from its cached state if enabled, otherwise from GLFW.
+        [[nodiscard]] MonitorOverlap findForWindow(const Window& window_)
+        {
+            const auto [xPos, yPos] = window_.getPos();
+            const auto [width, height] = window_.getSize();
+            const MonitorOverlap overlap = findMostOverlapping({xPos, yPos, width, height});
+            if(overlap.monitor)
+            {
+                return overlap;
+            }
+            return {findNearest(xPos + width / 2, yPos + height / 2), 0};
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_MONITOR_LAYOUT_H
@@ -0,0 +1,266 @@
+#ifndef GLFWPP_MONITOR_REGISTRY_H
+#define GLFWPP_MONITOR_REGISTRY_H
+
+#include "event.h"
+#include "helper.h"
+#include "monitor.h"
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace glfw
+{
+    struct MonitorInfo
+    {
+        Monitor monitor;
+        const char* name;  // Owned by the registry
+        bool primary;
+        int xPos, yPos;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        int workAreaXPos, workAreaYPos, workAreaWidth, workAreaHeight;
+        float xScale, yScale;
+#endif
+        int widthMillimeters, heightMillimeters;
+        VideoMode currentMode;
+        std::size_t firstMode;  // Range of the modes in MonitorRegistry::getVideoModes
+        std::size_t modeCount;
+    };
+
+    // Snapshot of all monitors and their video modes. The snapshot is taken
+    // on first use and again after it was invalidated by monitorEvent, by a
+    // content scale change of the attached window (GLFW 3.3) or by
+    // invalidate(). GLFW does not report video mode changes, neither those
+    // made by other applications nor the application's own through
+    // Window::setMonitor (including leaving full screen); call invalidate()
+    // after them if they matter. VideoModeIndex::setFullscreen does so.
+    //
+    // Views stay valid until a refresh finds a different snapshot, which
+    // is also when the generation changes.
+    class MonitorRegistry
+    {
+    private:
+        struct Snapshot
+        {
+            std::vector<MonitorInfo> monitors;
+            std::vector<VideoMode> modes;
+            std::vector<char> names;
+        };
+
+        Snapshot _snapshots[2];
+        std::size_t _current;
+        bool _valid;
+        std::uint64_t _generation;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        Subscription _contentScaleSubscription;
+#endif
+        detail::Hook<Monitor, MonitorEventType> _monitorHook;
+
+        static void _take(Snapshot& snapshot_)
+        {
+            snapshot_.monitors.clear();
+            snapshot_.modes.clear();
+            snapshot_.names.clear();
+
+            int count;
+            GLFWmonitor** pMonitors = glfwGetMonitors(&count);
+            GLFWmonitor* primary = glfwGetPrimaryMonitor();
+            for(int i = 0; i < count; ++i)
+            {
+                GLFWmonitor* handle = pMonitors[i];
+                MonitorInfo info{};
+                info.monitor = Monitor{handle};
+                info.primary = handle == primary;
+                glfwGetMonitorPos(handle, &info.xPos, &info.yPos);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                glfwGetMonitorWorkarea(handle, &info.workAreaXPos, &info.workAreaYPos, &info.workAreaWidth, &info.workAreaHeight);
+                glfwGetMonitorContentScale(handle, &info.xScale, &info.yScale);
+#endif
+                glfwGetMonitorPhysicalSize(handle, &info.widthMillimeters, &info.heightMillimeters);
+                if(const GLFWvidmode* pMode = glfwGetVideoMode(handle))
+                {
+                    info.currentMode = *pMode;
+                }
+
+                int modeCount = 0;
+                const GLFWvidmode* pModes = glfwGetVideoModes(handle, &modeCount);
+                info.firstMode = snapshot_.modes.size();
+                info.modeCount = pModes ? static_cast<std::size_t>(modeCount) : 0;
+                snapshot_.modes.insert(snapshot_.modes.end(), pModes, pModes + info.modeCount);
+
+                const char* name = glfwGetMonitorName(handle);
+                snapshot_.names.insert(snapshot_.names.end(), name, name + (name ? std::strlen(name) : 0));
+                snapshot_.names.push_back('\0');
+
+                snapshot_.monitors.push_back(info);
+            }
+
+            // The names are only pointed to once the buffer stopped growing
+            const char* name = snapshot_.names.data();
+            for(MonitorInfo& info : snapshot_.monitors)
+            {
+                info.name = name;
+                name += std::strlen(name) + 1;
+            }
+        }
+
+        [[nodiscard]] static bool _sameMode(const VideoMode& lhs_, const VideoMode& rhs_) noexcept
+        {
+            return lhs_.width == rhs_.width && lhs_.height == rhs_.height && lhs_.redBits == rhs_.redBits &&
+                   lhs_.greenBits == rhs_.greenBits && lhs_.blueBits == rhs_.blueBits && lhs_.refreshRate == rhs_.refreshRate;
+        }
+
+        [[nodiscard]] static bool _same(const Snapshot& lhs_, const Snapshot& rhs_) noexcept
+        {
+            if(lhs_.monitors.size() != rhs_.monitors.size() || lhs_.modes.size() != rhs_.modes.size() || lhs_.names != rhs_.names)
+            {
+                return false;
+            }
+            for(std::size_t i = 0; i < lhs_.monitors.size(); ++i)
+            {
+                const MonitorInfo& lhs = lhs_.monitors[i];
+                const MonitorInfo& rhs = rhs_.monitors[i];
+                if(static_cast<GLFWmonitor*>(lhs.monitor) != static_cast<GLFWmonitor*>(rhs.monitor) || lhs.primary != rhs.primary ||
+                        lhs.xPos != rhs.xPos || lhs.yPos != rhs.yPos ||
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                        lhs.workAreaXPos != rhs.workAreaXPos || lhs.workAreaYPos != rhs.workAreaYPos ||
+                        lhs.workAreaWidth != rhs.workAreaWidth || lhs.workAreaHeight != rhs.workAreaHeight ||
+                        lhs.xScale != rhs.xScale || lhs.yScale != rhs.yScale ||
+#endif
+                        lhs.widthMillimeters != rhs.widthMillimeters || lhs.heightMillimeters != rhs.heightMillimeters ||
+                        !_sameMode(lhs.currentMode, rhs.currentMode) || lhs.modeCount != rhs.modeCount)
+                {
+                    return false;
+                }
+            }
+            for(std::size_t i = 0; i < lhs_.modes.size(); ++i)
+            {
+                if(!_sameMode(lhs_.modes[i], rhs_.modes[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void _onMonitor(void* registry_, Monitor, MonitorEventType)
+        {
+            static_cast<MonitorRegistry*>(registry_)->invalidate();
+        }
+
+        const Snapshot& _get()
+        {
+            if(!_valid)
+            {
+                refresh();
+            }
+            return _snapshots[_current];
+        }
+
+    public:
+        MonitorRegistry() :
+            _snapshots{},
+            _current{0},
+            _valid{false},
+            _generation{0},
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            _contentScaleSubscription{},
+#endif
+            _monitorHook{}
+        {
+            _monitorHook.attach(detail::monitorHooks, &MonitorRegistry::_onMonitor, this);
+        }
+
+        MonitorRegistry(const MonitorRegistry&) = delete;
+        MonitorRegistry& operator=(const MonitorRegistry&) = delete;
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        // Also invalidates the snapshot when the content scale of `window_` changes
+        void attach(Window& window_)
+        {
+            _contentScaleSubscription = window_.contentScaleEvent.subscribe([this](Window&, float, float) {
+                invalidate();
+            });
+        }
+
+        void detach() noexcept
+        {
+            _contentScaleSubscription = {};
+        }
+#endif
+
+        void invalidate() noexcept
+        {
+            _valid = false;
+        }
+
+        [[nodiscard]] bool isValid() const noexcept
+        {
+            return _valid;
+        }
+
+        // Takes a new snapshot now. Returns true if it differs from the previous one.
+        bool refresh()
+        {
+            Snapshot& next = _snapshots[1 - _current];
+            _take(next);
+            _valid = true;
+            if(_generation != 0 && _same(next, _snapshots[_current]))
+            {
+                return false;
+            }
+            _current = 1 - _current;
+            ++_generation;
+            return true;
+        }
+
+        // Starts at 1 with the first snapshot and increases whenever it changes
+        [[nodiscard]] std::uint64_t getGeneration()
+        {
+            _get();
+            return _generation;
+        }
+
+        [[nodiscard]] ArrayView<MonitorInfo> getMonitors()
+        {
+            const Snapshot& snapshot = _get();
+            return {snapshot.monitors.data(), snapshot.monitors.size()};
+        }
+
+        // nullptr if there is no monitor
+        [[nodiscard]] const MonitorInfo* getPrimaryMonitor()
+        {
+            for(const MonitorInfo& info : _get().monitors)
+            {
+                if(info.primary)
+                {
+                    return &info;
+                }
+            }
+            return nullptr;
+        }
+
+        // nullptr if `monitor_` is not connected
+        [[nodiscard]] const MonitorInfo* find(Monitor monitor_)
+        {
+            for(const MonitorInfo& info : _get().monitors)
+            {
+                if(static_cast<GLFWmonitor*>(info.monitor) == static_cast<GLFWmonitor*>(monitor_))
+                {
+                    return &info;
+                }
+            }
+            return nullptr;
+        }
+
+        // Video modes of a monitor returned by this registry, in GLFW's order
+        [[nodiscard]] ArrayView<VideoMode> getVideoModes(const MonitorInfo& info_) const noexcept
+        {
+            return {_snapshots[_current].modes.data() + info_.firstMode, info_.modeCount};
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_MONITOR_REGISTRY_H
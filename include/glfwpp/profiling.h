@@ -0,0 +1,185 @@
+#ifndef GLFWPP_PROFILING_H
+#define GLFWPP_PROFILING_H
+
+#include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstdint>
+
+// Define GLFWPP_ENABLE_PROFILING before including glfwpp to measure the
+// GLFW callbacks and pollEvents/waitEvents. Without it the instrumentation
+// compiles to nothing and the queries below report zeros.
+#ifdef GLFWPP_ENABLE_PROFILING
+    #define GLFWPP_PROFILE_CALLBACK(slot_) const ::glfw::detail::CallbackProfileScope glfwppCallbackProfileScope{slot_}
+    #define GLFWPP_PROFILE_POLL() const ::glfw::detail::PollProfileScope glfwppPollProfileScope{false}
+    #define GLFWPP_PROFILE_DEFERRED() const ::glfw::detail::PollProfileScope glfwppDeferredProfileScope{true}
+#else
+    #define GLFWPP_PROFILE_CALLBACK(slot_)
+    #define GLFWPP_PROFILE_POLL()
+    #define GLFWPP_PROFILE_DEFERRED()
+#endif
+
+namespace glfw
+{
+    enum class WindowEventType : std::uint8_t;
+
+    constexpr bool profilingEnabled =
+#ifdef GLFWPP_ENABLE_PROFILING
+            true;
+#else
+            false;
+#endif
+
+    struct EventProfile
+    {
+        static constexpr std::size_t histogramSize = 16;
+
+        std::uint64_t callCount = 0;
+        double totalTime = 0;  // Seconds spent in the callback, including all handlers
+        // Bucket i counts calls that took less than 2^i microseconds (the
+        // last bucket counts all longer calls as well)
+        std::uint64_t histogram[histogramSize] = {};
+    };
+
+    struct PollProfile
+    {
+        std::uint64_t pollCount = 0;
+        double totalTime = 0;  // Seconds spent inside glfwPollEvents/glfwWaitEvents, including callbacks
+        double handlerTime = 0;  // Part of totalTime spent in callbacks
+        double deferredTime = 0;  // Seconds spent delivering deferred events after GLFW returned
+    };
+
+    namespace detail
+    {
+        struct ProfilingData
+        {
+            static constexpr std::size_t slotCount = 32;
+            static constexpr std::size_t monitorSlot = slotCount - 2;
+            static constexpr std::size_t joystickSlot = slotCount - 1;
+
+            EventProfile events[slotCount];
+            PollProfile poll;
+            unsigned callbackDepth = 0;
+            bool polling = false;
+        };
+
+        inline ProfilingData profilingData;
+
+        [[nodiscard]] inline double ticksToSeconds(std::uint64_t ticks_)
+        {
+            static const double secondsPerTick = 1.0 / static_cast<double>(glfwGetTimerFrequency());
+            return static_cast<double>(ticks_) * secondsPerTick;
+        }
+
+        [[nodiscard]] constexpr std::size_t profileSlot(WindowEventType type_) noexcept
+        {
+            return static_cast<std::size_t>(type_);
+        }
+
+        class CallbackProfileScope
+        {
+        private:
+            std::size_t _slot;
+            std::uint64_t _start;
+
+        public:
+            explicit CallbackProfileScope(std::size_t slot_) noexcept :
+                _slot{slot_},
+                _start{glfwGetTimerValue()}
+            {
+                ++profilingData.callbackDepth;
+            }
+
+            CallbackProfileScope(const CallbackProfileScope&) = delete;
+            CallbackProfileScope& operator=(const CallbackProfileScope&) = delete;
+
+            ~CallbackProfileScope() noexcept
+            {
+                const double elapsed = ticksToSeconds(glfwGetTimerValue() - _start);
+
+                EventProfile& profile = profilingData.events[_slot];
+                ++profile.callCount;
+                profile.totalTime += elapsed;
+
+                std::size_t bucket = 0;
+                for(double limit = 1e-6; elapsed >= limit && bucket + 1 < EventProfile::histogramSize; limit *= 2)
+                {
+                    ++bucket;
+                }
+                ++profile.histogram[bucket];
+
+                // Callbacks triggered from inside a handler are already part of the outer one
+                if(--profilingData.callbackDepth == 0 && profilingData.polling)
+                {
+                    profilingData.poll.handlerTime += elapsed;
+                }
+            }
+        };
+
+        class PollProfileScope
+        {
+        private:
+            bool _deferred;
+            std::uint64_t _start;
+
+        public:
+            explicit PollProfileScope(bool deferred_) noexcept :
+                _deferred{deferred_},
+                _start{glfwGetTimerValue()}
+            {
+                if(!_deferred)
+                {
+                    profilingData.polling = true;
+                }
+            }
+
+            PollProfileScope(const PollProfileScope&) = delete;
+            PollProfileScope& operator=(const PollProfileScope&) = delete;
+
+            ~PollProfileScope() noexcept
+            {
+                const double elapsed = ticksToSeconds(glfwGetTimerValue() - _start);
+                if(_deferred)
+                {
+                    profilingData.poll.deferredTime += elapsed;
+                }
+                else
+                {
+                    profilingData.polling = false;
+                    ++profilingData.poll.pollCount;
+                    profilingData.poll.totalTime += elapsed;
+                }
+            }
+        };
+    }  // namespace detail
+
+    [[nodiscard]] inline EventProfile getEventProfile(WindowEventType type_)
+    {
+        return detail::profilingData.events[detail::profileSlot(type_)];
+    }
+
+    [[nodiscard]] inline EventProfile getMonitorEventProfile()
+    {
+        return detail::profilingData.events[detail::ProfilingData::monitorSlot];
+    }
+
+    [[nodiscard]] inline EventProfile getJoystickEventProfile()
+    {
+        return detail::profilingData.events[detail::ProfilingData::joystickSlot];
+    }
+
+    [[nodiscard]] inline PollProfile getPollProfile()
+    {
+        return detail::profilingData.poll;
+    }
+
+    inline void resetProfiles()
+    {
+        for(EventProfile& profile : detail::profilingData.events)
+        {
+            profile = {};
+        }
+        detail::profilingData.poll = {};
+    }
+}  // namespace glfw
+
+#endif  //GLFWPP_PROFILING_H
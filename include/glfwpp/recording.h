@@ -0,0 +1,519 @@
+#ifndef GLFWPP_RECORDING_H
+#define GLFWPP_RECORDING_H
+
+#include "error.h"
+#include "event.h"
+#include "fake_clock.h"
+#include "mapped_file.h"
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+namespace glfw
+{
+    namespace detail
+    {
+        // Binary layout of a recording: the magic, a format byte, a flags byte
+        // and the timer frequency, followed by one record per event made of the
+        // event type, the timer ticks elapsed since the previous record and the
+        // payload. Integers are LEB128 varints (zigzag encoded when signed),
+        // floating point values are stored bit exact in little endian order and
+        // dropped paths are stored NUL terminated so they can be used in place.
+        constexpr char recordingMagic[8] = {'G', 'L', 'F', 'W', 'P', 'P', 'I', 'R'};
+        constexpr unsigned char recordingFormat = 1;
+        constexpr unsigned char recordingHasGlfw33Events = 0x01;
+
+        [[nodiscard]] constexpr unsigned char recordingFlags()
+        {
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            return recordingHasGlfw33Events;
+#else
+            return 0;
+#endif
+        }
+
+        [[nodiscard]] inline bool isLittleEndian() noexcept
+        {
+            const std::uint16_t probe = 1;
+            unsigned char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        [[noreturn]] inline void corruptRecording()
+        {
+            throw Error("Corrupt input recording");
+        }
+
+        inline std::uint64_t readRecordingVarint(const unsigned char*& cursor_, const unsigned char* end_)
+        {
+            std::uint64_t value = 0;
+            for(unsigned shift = 0; shift < 64 && cursor_ != end_; shift += 7)
+            {
+                const unsigned char byte = *cursor_++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if(!(byte & 0x80))
+                {
+                    return value;
+                }
+            }
+            corruptRecording();
+        }
+    }  // namespace detail
+
+    // Writes every event delivered to a window (after coalescing) to a binary
+    // stream, timestamped with the GLFW timer. Records are buffered and
+    // written out in blocks, on flush() and on destruction.
+    class InputRecorder
+    {
+    private:
+        static constexpr std::size_t _flushThreshold = 64 * 1024;
+
+        std::ostream& _stream;
+        std::vector<unsigned char> _buffer;
+        std::uint64_t _lastTimerValue;
+        std::uint64_t _recordedCount;
+        Subscription _subscription;
+
+        void _writeByte(unsigned char value_)
+        {
+            _buffer.push_back(value_);
+        }
+
+        void _writeVarint(std::uint64_t value_)
+        {
+            while(value_ >= 0x80)
+            {
+                _buffer.push_back(static_cast<unsigned char>(value_ | 0x80));
+                value_ >>= 7;
+            }
+            _buffer.push_back(static_cast<unsigned char>(value_));
+        }
+
+        void _writeSigned(std::int64_t value_)
+        {
+            _writeVarint((static_cast<std::uint64_t>(value_) << 1) ^ static_cast<std::uint64_t>(value_ >> 63));
+        }
+
+        template<typename T>
+        void _writeBits(T value_)
+        {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &value_, sizeof(T));
+            for(std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                // Stored little endian regardless of the host
+                _buffer.push_back(bytes[detail::isLittleEndian() ? i : sizeof(T) - 1 - i]);
+            }
+        }
+
+        void _record(const WindowEvent& event_)
+        {
+            const std::uint64_t timerValue = glfwGetTimerValue();
+            _writeByte(static_cast<unsigned char>(event_.type));
+            _writeVarint(timerValue - _lastTimerValue);
+            _lastTimerValue = timerValue;
+
+            switch(event_.type)
+            {
+                case WindowEventType::Pos:
+                    _writeSigned(event_.pos.x);
+                    _writeSigned(event_.pos.y);
+                    break;
+                case WindowEventType::Size:
+                case WindowEventType::FramebufferSize:
+                    _writeSigned(event_.size.width);
+                    _writeSigned(event_.size.height);
+                    break;
+                case WindowEventType::Close:
+                case WindowEventType::Refresh:
+                    break;
+                case WindowEventType::Focus:
+                case WindowEventType::Iconify:
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::Maximize:
+#endif
+                case WindowEventType::CursorEnter:
+                    _writeByte(event_.value);
+                    break;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::ContentScale:
+                    _writeBits(event_.contentScale.x);
+                    _writeBits(event_.contentScale.y);
+                    break;
+#endif
+                case WindowEventType::Key:
+                    _writeSigned(static_cast<int>(event_.key.key));
+                    _writeSigned(event_.key.scanCode);
+                    _writeByte(static_cast<unsigned char>(event_.key.state));
+                    _writeByte(static_cast<unsigned char>(event_.key.mods));
+                    break;
+                case WindowEventType::Char:
+                    _writeVarint(event_.codePoint);
+                    break;
+                case WindowEventType::MouseButton:
+                    _writeByte(static_cast<unsigned char>(event_.mouseButton.button));
+                    _writeByte(static_cast<unsigned char>(event_.mouseButton.state));
+                    _writeByte(static_cast<unsigned char>(event_.mouseButton.mods));
+                    break;
+                case WindowEventType::CursorPos:
+                    _writeBits(event_.cursorPos.x);
+                    _writeBits(event_.cursorPos.y);
+                    break;
+                case WindowEventType::Scroll:
+                    _writeBits(event_.scroll.x);
+                    _writeBits(event_.scroll.y);
+                    break;
+                case WindowEventType::Drop:
+                    _writeVarint(static_cast<std::uint64_t>(event_.drop.count));
+                    for(int i = 0; i < event_.drop.count; ++i)
+                    {
+                        const std::size_t length = std::strlen(event_.drop.paths[i]) + 1;
+                        _writeVarint(length);
+                        _buffer.insert(_buffer.end(), event_.drop.paths[i], event_.drop.paths[i] + length);
+                    }
+                    break;
+            }
+
+            ++_recordedCount;
+            if(_buffer.size() >= _flushThreshold)
+            {
+                flush();
+            }
+        }
+
+    public:
+        // Records the events of `window_` until the recorder is destroyed
+        InputRecorder(Window& window_, std::ostream& stream_) :
+            _stream{stream_},
+            _lastTimerValue{glfwGetTimerValue()},
+            _recordedCount{0}
+        {
+            _buffer.reserve(_flushThreshold + 256);
+            _buffer.insert(_buffer.end(), detail::recordingMagic, detail::recordingMagic + sizeof(detail::recordingMagic));
+            _writeByte(detail::recordingFormat);
+            _writeByte(detail::recordingFlags());
+            _writeVarint(glfwGetTimerFrequency());
+
+            _subscription = window_.anyEvent.subscribe([this](const WindowEvent& event_) {
+                _record(event_);
+            });
+        }
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        ~InputRecorder()
+        {
+            _subscription.reset();
+            flush();
+        }
+
+        void flush()
+        {
+            _stream.write(reinterpret_cast<const char*>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+            _stream.flush();
+            _buffer.clear();
+        }
+
+        [[nodiscard]] std::uint64_t getRecordedCount() const noexcept
+        {
+            return _recordedCount;
+        }
+    };
+
+    // Reads a recording made by InputRecorder from a memory mapped file and
+    // injects its events into a window with Window::injectEvent. The window
+    // does not need to be backed by a GLFW window, so a default constructed
+    // Window can be used to replay without a display. While the replayer
+    // exists it installs a FakeClock that follows the recorded timestamps,
+    // with 0 being the start of the recording.
+    class InputReplayer
+    {
+    private:
+        detail::MappedFile _file;
+        const unsigned char* _cursor;
+        const unsigned char* _end;
+        std::uint64_t _nextTimerValue;
+        bool _hasNext;
+        double _speed;
+        bool _started;
+        std::chrono::steady_clock::time_point _startTime;
+        std::vector<const char*> _paths;
+        FakeClock _clock;
+
+        [[noreturn]] static void _corrupt()
+        {
+            detail::corruptRecording();
+        }
+
+        unsigned char _readByte()
+        {
+            if(_cursor == _end)
+            {
+                _corrupt();
+            }
+            return *_cursor++;
+        }
+
+        std::uint64_t _readVarint()
+        {
+            return detail::readRecordingVarint(_cursor, _end);
+        }
+
+        std::int64_t _readSigned()
+        {
+            const std::uint64_t value = _readVarint();
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        template<typename T>
+        T _readBits()
+        {
+            if(static_cast<std::size_t>(_end - _cursor) < sizeof(T))
+            {
+                _corrupt();
+            }
+            unsigned char bytes[sizeof(T)];
+            for(std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                bytes[i] = _cursor[detail::isLittleEndian() ? i : sizeof(T) - 1 - i];
+            }
+            _cursor += sizeof(T);
+            T value;
+            std::memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+
+        // Looks ahead at the timestamp of the next record
+        void _peekNext()
+        {
+            _hasNext = _cursor != _end;
+            if(_hasNext)
+            {
+                const unsigned char* record = _cursor++;
+                _nextTimerValue += _readVarint();
+                _cursor = record;
+            }
+        }
+
+        WindowEvent _readEvent()
+        {
+            WindowEvent event{nullptr, static_cast<WindowEventType>(_readByte()), 0, {}};
+            _readVarint();
+
+            switch(event.type)
+            {
+                case WindowEventType::Pos:
+                    event.pos.x = static_cast<int>(_readSigned());
+                    event.pos.y = static_cast<int>(_readSigned());
+                    break;
+                case WindowEventType::Size:
+                case WindowEventType::FramebufferSize:
+                    event.size.width = static_cast<int>(_readSigned());
+                    event.size.height = static_cast<int>(_readSigned());
+                    break;
+                case WindowEventType::Close:
+                case WindowEventType::Refresh:
+                    break;
+                case WindowEventType::Focus:
+                case WindowEventType::Iconify:
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::Maximize:
+#endif
+                case WindowEventType::CursorEnter:
+                    event.value = _readByte();
+                    break;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::ContentScale:
+                    event.contentScale.x = _readBits<float>();
+                    event.contentScale.y = _readBits<float>();
+                    break;
+#endif
+                case WindowEventType::Key:
+                    event.key.key = static_cast<decltype(KeyCode::Unknown)>(_readSigned());
+                    event.key.scanCode = static_cast<int>(_readSigned());
+                    event.key.state = static_cast<KeyState>(_readByte());
+                    event.key.mods = static_cast<ModifierKeyBit>(_readByte());
+                    break;
+                case WindowEventType::Char:
+                    event.codePoint = static_cast<unsigned int>(_readVarint());
+                    break;
+                case WindowEventType::MouseButton:
+                    event.mouseButton.button = static_cast<MouseButton>(_readByte());
+                    event.mouseButton.state = static_cast<MouseButtonState>(_readByte());
+                    event.mouseButton.mods = static_cast<ModifierKeyBit>(_readByte());
+                    break;
+                case WindowEventType::CursorPos:
+                    event.cursorPos.x = _readBits<double>();
+                    event.cursorPos.y = _readBits<double>();
+                    break;
+                case WindowEventType::Scroll:
+                    event.scroll.x = _readBits<double>();
+                    event.scroll.y = _readBits<double>();
+                    break;
+                case WindowEventType::Drop:
+                {
+                    const std::uint64_t count = _readVarint();
+                    if(count > static_cast<std::uint64_t>(_end - _cursor))
+                    {
+                        _corrupt();
+                    }
+                    _paths.clear();
+                    for(std::uint64_t i = 0; i < count; ++i)
+                    {
+                        const std::uint64_t length = _readVarint();
+                        if(length == 0 || length > static_cast<std::uint64_t>(_end - _cursor) || _cursor[length - 1] != '\0')
+                        {
+                            _corrupt();
+                        }
+                        _paths.push_back(reinterpret_cast<const char*>(_cursor));
+                        _cursor += length;
+                    }
+                    event.drop.paths = _paths.data();
+                    event.drop.count = static_cast<int>(count);
+                    break;
+                }
+                default:
+                    _corrupt();
+            }
+            return event;
+        }
+
+        std::size_t _replayUntil(Window& window_, std::uint64_t timerValue_)
+        {
+            std::size_t count = 0;
+            while(_hasNext && _nextTimerValue <= timerValue_)
+            {
+                _clock.setTimerValue(_nextTimerValue);
+                WindowEvent event = _readEvent();
+                event.timestamp = _nextTimerValue;
+                _peekNext();
+                window_.injectEvent(event);
+                ++count;
+            }
+            if(timerValue_ > _clock.getTimerValue())
+            {
+                _clock.setTimerValue(timerValue_);
+            }
+            return count;
+        }
+
+        [[nodiscard]] std::uint64_t _toTimerValue(double time_) const
+        {
+            return time_ > 0 ? static_cast<std::uint64_t>(std::llround(time_ * static_cast<double>(_clock.getTimerFrequency()))) : 0;
+        }
+
+        // Validates the file header and returns the timer frequency of the recording
+        [[nodiscard]] static std::uint64_t _readHeader(const detail::MappedFile& file_)
+        {
+            const unsigned char* data = file_.data();
+            const std::size_t size = file_.size();
+            const std::size_t headerSize = sizeof(detail::recordingMagic) + 2;
+            if(size < headerSize || std::memcmp(data, detail::recordingMagic, sizeof(detail::recordingMagic)) != 0)
+            {
+                throw Error("Not an input recording");
+            }
+            if(data[sizeof(detail::recordingMagic)] != detail::recordingFormat ||
+                    data[sizeof(detail::recordingMagic) + 1] != detail::recordingFlags())
+            {
+                throw Error("Input recording was made with an incompatible version");
+            }
+
+            const unsigned char* cursor = data + headerSize;
+            const std::uint64_t frequency = detail::readRecordingVarint(cursor, data + size);
+            if(frequency == 0)
+            {
+                detail::corruptRecording();
+            }
+            return frequency;
+        }
+
+    public:
+        // A speed of 2 replays twice as fast as the events were recorded
+        explicit InputReplayer(const char* path_, double speed_ = 1.0) :
+            _file{path_},
+            _cursor{},
+            _end{},
+            _nextTimerValue{0},
+            _hasNext{false},
+            _speed{speed_},
+            _started{false},
+            _startTime{},
+            _paths{},
+            _clock{_readHeader(_file)}
+        {
+            _cursor = _file.data() + sizeof(detail::recordingMagic) + 2;
+            _end = _file.data() + _file.size();
+            _readVarint();
+            _peekNext();
+        }
+
+        InputReplayer(const InputReplayer&) = delete;
+        InputReplayer& operator=(const InputReplayer&) = delete;
+
+        // Injects all events that are due according to the time elapsed since
+        // the first call, scaled by the replay speed. Call once per frame.
+        std::size_t replay(Window& window_)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if(!_started)
+            {
+                _started = true;
+                _startTime = now;
+            }
+            const double elapsed = std::chrono::duration<double>(now - _startTime).count() * _speed;
+            return _replayUntil(window_, _toTimerValue(elapsed));
+        }
+
+        // Injects all events recorded up to `time_` seconds after the start of
+        // the recording, independently of the wall clock
+        std::size_t replayUntil(Window& window_, double time_)
+        {
+            return _replayUntil(window_, _toTimerValue(time_));
+        }
+
+        std::size_t replayAll(Window& window_)
+        {
+            std::size_t count = 0;
+            while(_hasNext)
+            {
+                count += _replayUntil(window_, _nextTimerValue);
+            }
+            return count;
+        }
+
+        void setSpeed(double speed_)
+        {
+            _speed = speed_;
+        }
+
+        [[nodiscard]] double getSpeed() const
+        {
+            return _speed;
+        }
+
+        [[nodiscard]] bool finished() const noexcept
+        {
+            return !_hasNext;
+        }
+
+        // Recording time of the next event in seconds
+        [[nodiscard]] double getNextEventTime() const noexcept
+        {
+            return static_cast<double>(_nextTimerValue) / static_cast<double>(_clock.getTimerFrequency());
+        }
+
+        [[nodiscard]] const FakeClock& getClock() const noexcept
+        {
+            return _clock;
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_RECORDING_H
@@ -0,0 +1,275 @@
+#ifndef GLFWPP_VIDEO_MODE_INDEX_H
+#define GLFWPP_VIDEO_MODE_INDEX_H
+
+#include "helper.h"
+#include "monitor.h"
+#include "monitor_registry.h"
+#include "window.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace glfw
+{
+    // Video modes of one resolution, see VideoModeIndex::getResolutions
+    struct VideoModeGroup
+    {
+        int width, height;
+        std::size_t firstMode;  // Range in VideoModeIndex::getModes, sorted by refresh rate and bit depth
+        std::size_t modeCount;
+    };
+
+    // Video modes of all monitors, sorted by pixel count, resolution, refresh
+    // rate and bit depth and grouped by resolution, for nearest-match
+    // queries in logarithmic time. Built from a MonitorRegistry, which must
+    // outlive the index, and rebuilt when its generation changes.
+    class VideoModeIndex
+    {
+    private:
+        struct MonitorEntry
+        {
+            GLFWmonitor* monitor;
+            int currentBits;
+            std::size_t firstMode;
+            std::size_t modeCount;
+            std::size_t firstGroup;
+            std::size_t groupCount;
+        };
+
+        MonitorRegistry& _registry;
+        std::uint64_t _generation;
+        std::vector<MonitorEntry> _monitors;
+        std::vector<VideoMode> _modes;
+        std::vector<VideoModeGroup> _groups;
+
+        [[nodiscard]] static int _bits(const VideoMode& mode_) noexcept
+        {
+            return mode_.redBits + mode_.greenBits + mode_.blueBits;
+        }
+
+        [[nodiscard]] static std::int64_t _area(int width_, int height_) noexcept
+        {
+            return static_cast<std::int64_t>(width_) * height_;
+        }
+
+        [[nodiscard]] static bool _less(const VideoMode& lhs_, const VideoMode& rhs_) noexcept
+        {
+            const std::int64_t lhsArea = _area(lhs_.width, lhs_.height), rhsArea = _area(rhs_.width, rhs_.height);
+            if(lhsArea != rhsArea)
+            {
+                return lhsArea < rhsArea;
+            }
+            if(lhs_.width != rhs_.width)
+            {
+                return lhs_.width < rhs_.width;
+            }
+            if(lhs_.refreshRate != rhs_.refreshRate)
+            {
+                return lhs_.refreshRate < rhs_.refreshRate;
+            }
+            if(_bits(lhs_) != _bits(rhs_))
+            {
+                return _bits(lhs_) < _bits(rhs_);
+            }
+            return lhs_.redBits < rhs_.redBits || (lhs_.redBits == rhs_.redBits && lhs_.greenBits < rhs_.greenBits);
+        }
+
+        [[nodiscard]] static bool _equal(const VideoMode& lhs_, const VideoMode& rhs_) noexcept
+        {
+            return !_less(lhs_, rhs_) && !_less(rhs_, lhs_);
+        }
+
+        void _build()
+        {
+            _monitors.clear();
+            _modes.clear();
+            _groups.clear();
+
+            for(const MonitorInfo& info : _registry.getMonitors())
+            {
+                MonitorEntry entry{static_cast<GLFWmonitor*>(info.monitor), _bits(info.currentMode), _modes.size(), 0, _groups.size(), 0};
+
+                const ArrayView<VideoMode> modes = _registry.getVideoModes(info);
+                _modes.insert(_modes.end(), modes.begin(), modes.end());
+                const auto first = _modes.begin() + static_cast<std::ptrdiff_t>(entry.firstMode);
+                std::sort(first, _modes.end(), _less);
+                _modes.erase(std::unique(first, _modes.end(), _equal), _modes.end());
+                entry.modeCount = _modes.size() - entry.firstMode;
+
+                for(std::size_t i = entry.firstMode; i < _modes.size(); ++i)
+                {
+                    if(_groups.size() == entry.firstGroup || _groups.back().width != _modes[i].width || _groups.back().height != _modes[i].height)
+                    {
+                        _groups.push_back({_modes[i].width, _modes[i].height, i, 0});
+                    }
+                    ++_groups.back().modeCount;
+                }
+                entry.groupCount = _groups.size() - entry.firstGroup;
+
+                _monitors.push_back(entry);
+            }
+            _generation = _registry.getGeneration();
+        }
+
+        const MonitorEntry* _find(Monitor monitor_)
+        {
+            if(_generation != _registry.getGeneration())
+            {
+                _build();
+            }
+            for(const MonitorEntry& entry : _monitors)
+            {
+                if(entry.monitor == static_cast<GLFWmonitor*>(monitor_))
+                {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        // Resolution group with the pixel count closest to the target, ties
+        // broken by the squared size difference
+        [[nodiscard]] const VideoModeGroup* _nearestGroup(const MonitorEntry& entry_, int width_, int height_) const noexcept
+        {
+            const VideoModeGroup* begin = _groups.data() + entry_.firstGroup;
+            const VideoModeGroup* end = begin + entry_.groupCount;
+            const std::int64_t area = _area(width_, height_);
+            const VideoModeGroup* split = std::lower_bound(begin, end, area, [](const VideoModeGroup& group_, std::int64_t area_) {
+                return _area(group_.width, group_.height) < area_;
+            });
+
+            // Candidates are the pixel count runs just below and from the split on
+            const VideoModeGroup* low = split;
+            if(low != begin)
+            {
+                const std::int64_t belowArea = _area((low - 1)->width, (low - 1)->height);
+                while(low != begin && _area((low - 1)->width, (low - 1)->height) == belowArea)
+                {
+                    --low;
+                }
+            }
+            const VideoModeGroup* high = split;
+            if(high != end)
+            {
+                const std::int64_t aboveArea = _area(high->width, high->height);
+                while(high != end && _area(high->width, high->height) == aboveArea)
+                {
+                    ++high;
+                }
+            }
+
+            const VideoModeGroup* best = nullptr;
+            std::int64_t bestAreaDistance = 0, bestSizeDistance = 0;
+            for(const VideoModeGroup* group = low; group != high; ++group)
+            {
+                const std::int64_t groupArea = _area(group->width, group->height);
+                const std::int64_t areaDistance = groupArea > area ? groupArea - area : area - groupArea;
+                const std::int64_t sizeDistance = _area(group->width - width_, group->width - width_) + _area(group->height - height_, group->height - height_);
+                if(!best || areaDistance < bestAreaDistance || (areaDistance == bestAreaDistance && sizeDistance < bestSizeDistance))
+                {
+                    best = group;
+                    bestAreaDistance = areaDistance;
+                    bestSizeDistance = sizeDistance;
+                }
+            }
+            return best;
+        }
+
+    public:
+        explicit VideoModeIndex(MonitorRegistry& registry_) :
+            _registry{registry_},
+            _generation{0},
+            _monitors{},
+            _modes{},
+            _groups{}
+        {
+        }
+
+        VideoModeIndex(const VideoModeIndex&) = delete;
+        VideoModeIndex& operator=(const VideoModeIndex&) = delete;
+
+        // Modes of `monitor_` without duplicates, in index order
+        [[nodiscard]] ArrayView<VideoMode> getModes(Monitor monitor_)
+        {
+            const MonitorEntry* entry = _find(monitor_);
+            return entry ? ArrayView<VideoMode>{_modes.data() + entry->firstMode, entry->modeCount} : ArrayView<VideoMode>{};
+        }
+
+        // Distinct resolutions of `monitor_`, sorted by pixel count
+        [[nodiscard]] ArrayView<VideoModeGroup> getResolutions(Monitor monitor_)
+        {
+            const MonitorEntry* entry = _find(monitor_);
+            return entry ? ArrayView<VideoModeGroup>{_groups.data() + entry->firstGroup, entry->groupCount} : ArrayView<VideoModeGroup>{};
+        }
+
+        // The mode of `monitor_` closest to the requested one: first the
+        // resolution with the nearest pixel count, then the nearest refresh
+        // rate (the highest for dontCare, the higher one on ties), then the
+        // bit depth of the current mode if available or else the highest.
+        // nullptr if the monitor is not connected or reports no modes.
+        [[nodiscard]] const VideoMode* findNearest(Monitor monitor_, int width_, int height_, int refreshRate_ = dontCare, bool preferCurrentBitDepth_ = true)
+        {
+            const MonitorEntry* entry = _find(monitor_);
+            if(!entry || !entry->groupCount)
+            {
+                return nullptr;
+            }
+
+            const VideoModeGroup* group = _nearestGroup(*entry, width_, height_);
+            const VideoMode* begin = _modes.data() + group->firstMode;
+            const VideoMode* end = begin + group->modeCount;
+
+            int refreshRate = (end - 1)->refreshRate;
+            if(refreshRate_ != dontCare)
+            {
+                const VideoMode* split = std::lower_bound(begin, end, refreshRate_, [](const VideoMode& mode_, int target_) {
+                    return mode_.refreshRate < target_;
+                });
+                if(split != end)
+                {
+                    refreshRate = split->refreshRate;
+                }
+                if(split != begin && (split == end || refreshRate_ - (split - 1)->refreshRate < split->refreshRate - refreshRate_))
+                {
+                    refreshRate = (split - 1)->refreshRate;
+                }
+            }
+
+            // Modes of one refresh rate are sorted by bit depth
+            const VideoMode* last = std::upper_bound(begin, end, refreshRate, [](int target_, const VideoMode& mode_) {
+                return target_ < mode_.refreshRate;
+            });
+            const VideoMode* best = last - 1;
+            if(preferCurrentBitDepth_)
+            {
+                for(const VideoMode* mode = last; mode != begin && (mode - 1)->refreshRate == refreshRate; --mode)
+                {
+                    if(_bits(*(mode - 1)) == entry->currentBits)
+                    {
+                        return mode - 1;
+                    }
+                }
+            }
+            return best;
+        }
+
+        // Makes `window_` full screen on `monitor_` with the mode found by
+        // findNearest. Returns that mode, or nullptr without changing the
+        // window if there is none. GLFW reports no event for the mode
+        // switch, so the registry is invalidated here.
+        const VideoMode* setFullscreen(Window& window_, Monitor monitor_, int width_, int height_, int refreshRate_ = dontCare)
+        {
+            const VideoMode* mode = findNearest(monitor_, width_, height_, refreshRate_);
+            if(mode)
+            {
+                window_.setMonitor(monitor_, *mode);
+                _registry.invalidate();
+            }
+            return mode;
+        }
+    };
+}  // namespace glfw
+
+#endif  //GLFWPP_VIDEO_MODE_INDEX_H
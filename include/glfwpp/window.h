@@ -7,7 +7,13 @@
 #include "monitor.h"
 #include "version.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace glfw
 {
@@ -434,6 +440,735 @@ namespace glfw
         Release = GLFW_RELEASE
     };
 
+    class Window;
+
+    // Non-owning view of the paths of a drop. The paths are owned by GLFW and
+    // only valid until the drop handlers return.
+    class PathsView
+    {
+    private:
+        const char* const* _paths;
+        std::size_t _count;
+
+    public:
+        PathsView(const char* const* paths_, std::size_t count_) noexcept :
+            _paths{paths_},
+            _count{count_}
+        {
+        }
+
+        [[nodiscard]] const char* const* begin() const noexcept
+        {
+            return _paths;
+        }
+
+        [[nodiscard]] const char* const* end() const noexcept
+        {
+            return _paths + _count;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return _count;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return _count == 0;
+        }
+
+        [[nodiscard]] const char* operator[](std::size_t index_) const noexcept
+        {
+            return _paths[index_];
+        }
+    };
+
+    enum class WindowEventType : std::uint8_t
+    {
+        Pos,
+        Size,
+        Close,
+        Refresh,
+        Focus,
+        Iconify,
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        Maximize,
+#endif
+        FramebufferSize,
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        ContentScale,
+#endif
+        Key,
+        Char,
+        MouseButton,
+        CursorPos,
+        CursorEnter,
+        Scroll,
+        Drop
+    };
+
+    // Compact tagged record of a single window event. The active member of
+    // the union is selected by `type`.
+    struct WindowEvent
+    {
+        Window* window;  // Not updated when the Window object is moved, see Window::setEventQueue
+        WindowEventType type;
+        std::uint64_t timestamp;  // 0 unless event timestamps are enabled
+        union
+        {
+            struct
+            {
+                int x;
+                int y;
+            } pos;
+            struct
+            {
+                int width;
+                int height;
+            } size;  // Size and FramebufferSize
+            bool value;  // Focus, Iconify, Maximize and CursorEnter
+            struct
+            {
+                float x;
+                float y;
+            } contentScale;
+            struct
+            {
+                KeyCode key;
+                int scanCode;
+                KeyState state;
+                ModifierKeyBit mods;
+            } key;
+            unsigned int codePoint;
+            struct
+            {
+                MouseButton button;
+                MouseButtonState state;
+                ModifierKeyBit mods;
+            } mouseButton;
+            struct
+            {
+                double x;
+                double y;
+            } cursorPos;
+            struct
+            {
+                double x;
+                double y;
+            } scroll;
+            struct
+            {
+                const char* const* paths;
+                int count;
+            } drop;
+        };
+    };
+
+    // Selects the window events that are merged while GLFW processes events
+    // and delivered once at the end of pollEvents/waitEvents. Positions and
+    // sizes keep the last value, scroll offsets are summed.
+    struct EventCoalescing
+    {
+        bool pos = false;
+        bool size = false;
+        bool framebufferSize = false;
+        bool cursorPos = false;
+        bool scroll = false;
+    };
+
+    // Number of raw events that were merged into another event
+    struct CoalescingStats
+    {
+        std::uint64_t pos = 0;
+        std::uint64_t size = 0;
+        std::uint64_t framebufferSize = 0;
+        std::uint64_t cursorPos = 0;
+        std::uint64_t scroll = 0;
+    };
+
+    // Outcome of the property changes recorded while deferred properties are
+    // enabled, see Window::setDeferredPropertiesEnabled
+    struct DeferredPropertyStats
+    {
+        std::uint64_t applied = 0;  // Changes passed to GLFW
+        std::uint64_t skipped = 0;  // Changes overwritten before a flush or equal to the applied value
+    };
+
+    // Fixed-size bit set with one bit per key code and mouse button. Set
+    // operations work on whole words so they are easily vectorized.
+    struct InputBits
+    {
+        static constexpr std::size_t keyCount = GLFW_KEY_LAST + 1;
+        static constexpr std::size_t mouseButtonCount = GLFW_MOUSE_BUTTON_LAST + 1;
+        static constexpr std::size_t bitCount = keyCount + mouseButtonCount;
+        static constexpr std::size_t wordCount = (bitCount + 63) / 64;
+
+        std::uint64_t words[wordCount] = {};
+
+        // Returns bitCount for KeyCode::Unknown
+        [[nodiscard]] static std::size_t indexOf(KeyCode key_) noexcept
+        {
+            const int key = key_;
+            return key >= 0 && key < static_cast<int>(keyCount) ? static_cast<std::size_t>(key) : bitCount;
+        }
+        [[nodiscard]] static std::size_t indexOf(MouseButton button_) noexcept
+        {
+            const int button = static_cast<int>(button_);
+            return button >= 0 && button < static_cast<int>(mouseButtonCount) ? keyCount + static_cast<std::size_t>(button) : bitCount;
+        }
+
+        [[nodiscard]] bool test(std::size_t index_) const noexcept
+        {
+            return index_ < bitCount && (words[index_ / 64] >> (index_ % 64) & 1);
+        }
+        [[nodiscard]] bool test(KeyCode key_) const noexcept
+        {
+            return test(indexOf(key_));
+        }
+        [[nodiscard]] bool test(MouseButton button_) const noexcept
+        {
+            return test(indexOf(button_));
+        }
+
+        void set(std::size_t index_, bool value_) noexcept
+        {
+            if(index_ < bitCount)
+            {
+                const std::uint64_t mask = std::uint64_t{1} << (index_ % 64);
+                words[index_ / 64] = value_ ? words[index_ / 64] | mask : words[index_ / 64] & ~mask;
+            }
+        }
+
+        [[nodiscard]] bool any() const noexcept
+        {
+            std::uint64_t result = 0;
+            for(std::size_t i = 0; i < wordCount; ++i)
+            {
+                result |= words[i];
+            }
+            return result != 0;
+        }
+
+        [[nodiscard]] friend InputBits operator&(const InputBits& lhs_, const InputBits& rhs_) noexcept
+        {
+            InputBits result;
+            for(std::size_t i = 0; i < wordCount; ++i)
+            {
+                result.words[i] = lhs_.words[i] & rhs_.words[i];
+            }
+            return result;
+        }
+        [[nodiscard]] friend InputBits operator|(const InputBits& lhs_, const InputBits& rhs_) noexcept
+        {
+            InputBits result;
+            for(std::size_t i = 0; i < wordCount; ++i)
+            {
+                result.words[i] = lhs_.words[i] | rhs_.words[i];
+            }
+            return result;
+        }
+        [[nodiscard]] friend InputBits operator^(const InputBits& lhs_, const InputBits& rhs_) noexcept
+        {
+            InputBits result;
+            for(std::size_t i = 0; i < wordCount; ++i)
+            {
+                result.words[i] = lhs_.words[i] ^ rhs_.words[i];
+            }
+            return result;
+        }
+        [[nodiscard]] InputBits operator~() const noexcept
+        {
+            InputBits result;
+            for(std::size_t i = 0; i < wordCount; ++i)
+            {
+                result.words[i] = ~words[i];
+            }
+            return result;
+        }
+    };
+
+    // Keyboard and mouse state of a window, kept up to date from its key,
+    // mouse button, cursor position and scroll callbacks (see
+    // Window::setInputStateEnabled). Queries do not call into GLFW. A frame
+    // starts with newFrame(); wentDown/wentUp report presses and releases
+    // since then, so a key tapped within one frame went both down and up.
+    class InputState
+    {
+    private:
+        InputBits _down;
+        InputBits _previousDown;
+        InputBits _pressed;
+        InputBits _released;
+        double _cursorX = 0;
+        double _cursorY = 0;
+        double _cursorDeltaX = 0;
+        double _cursorDeltaY = 0;
+        double _scrollX = 0;
+        double _scrollY = 0;
+        ModifierKeyBit _mods{};
+
+        friend class Window;
+
+        void _setButton(std::size_t index_, bool pressed_) noexcept
+        {
+            _down.set(index_, pressed_);
+            if(pressed_)
+            {
+                _pressed.set(index_, true);
+            }
+            else
+            {
+                _released.set(index_, true);
+            }
+        }
+
+        void _update(const WindowEvent& event_) noexcept
+        {
+            switch(event_.type)
+            {
+                case WindowEventType::Key:
+                    _mods = event_.key.mods;
+                    if(event_.key.state != KeyState::Repeat)
+                    {
+                        _setButton(InputBits::indexOf(event_.key.key), event_.key.state == KeyState::Press);
+                    }
+                    break;
+                case WindowEventType::MouseButton:
+                    _mods = event_.mouseButton.mods;
+                    _setButton(InputBits::indexOf(event_.mouseButton.button), event_.mouseButton.state == MouseButtonState::Press);
+                    break;
+                case WindowEventType::CursorPos:
+                    _cursorDeltaX += event_.cursorPos.x - _cursorX;
+                    _cursorDeltaY += event_.cursorPos.y - _cursorY;
+                    _cursorX = event_.cursorPos.x;
+                    _cursorY = event_.cursorPos.y;
+                    break;
+                case WindowEventType::Scroll:
+                    _scrollX += event_.scroll.x;
+                    _scrollY += event_.scroll.y;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+    public:
+        // Call once per frame before polling
+        void newFrame() noexcept
+        {
+            _previousDown = _down;
+            _pressed = {};
+            _released = {};
+            _cursorDeltaX = _cursorDeltaY = 0;
+            _scrollX = _scrollY = 0;
+        }
+
+        [[nodiscard]] bool isDown(KeyCode key_) const noexcept
+        {
+            return _down.test(key_);
+        }
+        [[nodiscard]] bool isDown(MouseButton button_) const noexcept
+        {
+            return _down.test(button_);
+        }
+        [[nodiscard]] bool wentDown(KeyCode key_) const noexcept
+        {
+            return _pressed.test(key_);
+        }
+        [[nodiscard]] bool wentDown(MouseButton button_) const noexcept
+        {
+            return _pressed.test(button_);
+        }
+        [[nodiscard]] bool wentUp(KeyCode key_) const noexcept
+        {
+            return _released.test(key_);
+        }
+        [[nodiscard]] bool wentUp(MouseButton button_) const noexcept
+        {
+            return _released.test(button_);
+        }
+
+        [[nodiscard]] const InputBits& getDown() const noexcept
+        {
+            return _down;
+        }
+        // State at the last newFrame()
+        [[nodiscard]] const InputBits& getPreviousDown() const noexcept
+        {
+            return _previousDown;
+        }
+        [[nodiscard]] const InputBits& getPressed() const noexcept
+        {
+            return _pressed;
+        }
+        [[nodiscard]] const InputBits& getReleased() const noexcept
+        {
+            return _released;
+        }
+        // Keys and buttons whose state differs from the last newFrame()
+        [[nodiscard]] InputBits getChanged() const noexcept
+        {
+            return _down ^ _previousDown;
+        }
+
+        [[nodiscard]] std::tuple<double, double> getCursorPos() const noexcept
+        {
+            return {_cursorX, _cursorY};
+        }
+        // Cursor movement since the last newFrame()
+        [[nodiscard]] std::tuple<double, double> getCursorDelta() const noexcept
+        {
+            return {_cursorDeltaX, _cursorDeltaY};
+        }
+        // Sum of the scroll offsets since the last newFrame()
+        [[nodiscard]] std::tuple<double, double> getScrollOffset() const noexcept
+        {
+            return {_scrollX, _scrollY};
+        }
+        // Modifiers of the last key or mouse button event
+        [[nodiscard]] ModifierKeyBit getMods() const noexcept
+        {
+            return _mods;
+        }
+    };
+
+    // Cursor movement summed over the samples since the last clear().
+    // Timestamps are timer values (see getTimerValue).
+    struct MouseMotion
+    {
+        double deltaX = 0;
+        double deltaY = 0;
+        std::uint64_t sampleCount = 0;
+        std::uint64_t firstTimestamp = 0;
+        std::uint64_t lastTimestamp = 0;
+    };
+
+    struct MouseMotionSample
+    {
+        double deltaX;
+        double deltaY;
+        std::uint64_t timestamp;
+    };
+
+    // Accumulates the cursor position samples of a window as deltas, for
+    // example for camera control with CursorMode::Disabled and raw mouse
+    // motion. Attach it with Window::setMouseMotionAccumulator; samples are
+    // recorded inside the GLFW callback before any coalescing and without
+    // invoking user code. Every delta is computed from two consecutive
+    // positions, so the totals do not lose precision when the virtual cursor
+    // position becomes large. With a sample capacity, the individual samples
+    // of the frame are kept in a ring as well.
+    class MouseMotionAccumulator
+    {
+    private:
+        MouseMotion _motion;
+        double _lastX;
+        double _lastY;
+        bool _hasPosition;
+        std::vector<MouseMotionSample> _samples;
+        std::size_t _firstSample;
+        std::size_t _sampleCount;
+        std::uint64_t _droppedSamples;
+
+        friend class Window;
+
+        void _setPosition(double xPos_, double yPos_) noexcept
+        {
+            _lastX = xPos_;
+            _lastY = yPos_;
+            _hasPosition = true;
+        }
+
+        void _addPosition(double xPos_, double yPos_, std::uint64_t timestamp_) noexcept
+        {
+            if(!_hasPosition)
+            {
+                _setPosition(xPos_, yPos_);
+                return;
+            }
+
+            const double deltaX = xPos_ - _lastX;
+            const double deltaY = yPos_ - _lastY;
+            _setPosition(xPos_, yPos_);
+
+            _motion.deltaX += deltaX;
+            _motion.deltaY += deltaY;
+            if(_motion.sampleCount++ == 0)
+            {
+                _motion.firstTimestamp = timestamp_;
+            }
+            _motion.lastTimestamp = timestamp_;
+
+            if(_samples.empty())
+            {
+                return;
+            }
+            if(_sampleCount == _samples.size())
+            {
+                // Keep the newest samples
+                _firstSample = (_firstSample + 1) % _samples.size();
+                --_sampleCount;
+                ++_droppedSamples;
+            }
+            _samples[(_firstSample + _sampleCount++) % _samples.size()] = {deltaX, deltaY, timestamp_};
+        }
+
+    public:
+        explicit MouseMotionAccumulator(std::size_t sampleCapacity_ = 0) :
+            _motion{},
+            _lastX{0},
+            _lastY{0},
+            _hasPosition{false},
+            _samples(sampleCapacity_),
+            _firstSample{0},
+            _sampleCount{0},
+            _droppedSamples{0}
+        {
+        }
+
+        MouseMotionAccumulator(const MouseMotionAccumulator&) = delete;
+        MouseMotionAccumulator& operator=(const MouseMotionAccumulator&) = delete;
+
+        // Call once per frame before polling
+        void clear() noexcept
+        {
+            _motion = {};
+            _firstSample = 0;
+            _sampleCount = 0;
+        }
+
+        // The next sample only establishes the position, e.g. after the
+        // cursor was warped with setCursorPos or the cursor mode changed
+        void forgetPosition() noexcept
+        {
+            _hasPosition = false;
+        }
+
+        [[nodiscard]] const MouseMotion& getMotion() const noexcept
+        {
+            return _motion;
+        }
+
+        // Number of stored samples, at most the sample capacity
+        [[nodiscard]] std::size_t getSampleCount() const noexcept
+        {
+            return _sampleCount;
+        }
+
+        [[nodiscard]] std::size_t getSampleCapacity() const noexcept
+        {
+            return _samples.size();
+        }
+
+        // Oldest sample first
+        [[nodiscard]] const MouseMotionSample& getSample(std::size_t index_) const noexcept
+        {
+            return _samples[(_firstSample + index_) % _samples.size()];
+        }
+
+        // Samples that did not fit into the ring since construction
+        [[nodiscard]] std::uint64_t getDroppedSampleCount() const noexcept
+        {
+            return _droppedSamples;
+        }
+    };
+
+    // Per-frame buffer of window events. While a queue is attached to a window
+    // with Window::setEventQueue, the window's events are appended to the queue
+    // instead of being dispatched immediately. Dropped paths are copied into an
+    // arena owned by the queue and stay valid until the next clear(). Queued
+    // events point to their Window object, which must not be moved or
+    // destroyed until the queue has been cleared.
+    class EventQueue
+    {
+    private:
+        std::vector<WindowEvent> _events;
+        detail::FrameArena _arena;
+
+        friend class Window;
+
+        void _push(const WindowEvent& event_)
+        {
+            WindowEvent& event = _events.emplace_back(event_);
+            if(event.type == WindowEventType::Drop)
+            {
+                const char** paths = _arena.allocateArray<const char*>(event.drop.count);
+                for(int i = 0; i < event.drop.count; ++i)
+                {
+                    paths[i] = _arena.copyString(event.drop.paths[i]);
+                }
+                event.drop.paths = paths;
+            }
+        }
+
+    public:
+        explicit EventQueue(std::size_t capacity_ = 256)
+        {
+            _events.reserve(capacity_);
+        }
+
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        // Call once per frame before polling. Keeps all allocated memory.
+        void clear() noexcept
+        {
+            _events.clear();
+            _arena.reset();
+        }
+
+        [[nodiscard]] const WindowEvent* begin() const noexcept
+        {
+            return _events.data();
+        }
+
+        [[nodiscard]] const WindowEvent* end() const noexcept
+        {
+            return _events.data() + _events.size();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return _events.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return _events.empty();
+        }
+
+        // Invokes the Event objects of the windows in the order the events were received
+        inline void dispatch() const;
+    };
+
+    // Geometry and attributes of a window as last reported by its callbacks,
+    // see Window::setStateCachingEnabled
+    class WindowState
+    {
+    private:
+        int _xPos = 0;
+        int _yPos = 0;
+        int _width = 0;
+        int _height = 0;
+        int _framebufferWidth = 0;
+        int _framebufferHeight = 0;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        float _xScale = 1;
+        float _yScale = 1;
+#endif
+        double _cursorX = 0;
+        double _cursorY = 0;
+        bool _focused = false;
+        bool _iconified = false;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        bool _maximized = false;
+#endif
+        bool _hovered = false;
+        bool _visible = false;
+
+        friend class Window;
+
+        void _update(const WindowEvent& event_) noexcept
+        {
+            switch(event_.type)
+            {
+                case WindowEventType::Pos:
+                    _xPos = event_.pos.x;
+                    _yPos = event_.pos.y;
+                    break;
+                case WindowEventType::Size:
+                    _width = event_.size.width;
+                    _height = event_.size.height;
+                    break;
+                case WindowEventType::FramebufferSize:
+                    _framebufferWidth = event_.size.width;
+                    _framebufferHeight = event_.size.height;
+                    break;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::ContentScale:
+                    _xScale = event_.contentScale.x;
+                    _yScale = event_.contentScale.y;
+                    break;
+#endif
+                case WindowEventType::Focus:
+                    _focused = event_.value;
+                    break;
+                case WindowEventType::Iconify:
+                    _iconified = event_.value;
+                    break;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::Maximize:
+                    _maximized = event_.value;
+                    break;
+#endif
+                case WindowEventType::CursorPos:
+                    _cursorX = event_.cursorPos.x;
+                    _cursorY = event_.cursorPos.y;
+                    break;
+                case WindowEventType::CursorEnter:
+                    _hovered = event_.value;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+    public:
+        [[nodiscard]] std::tuple<int, int> getPos() const noexcept
+        {
+            return {_xPos, _yPos};
+        }
+
+        [[nodiscard]] std::tuple<int, int> getSize() const noexcept
+        {
+            return {_width, _height};
+        }
+
+        [[nodiscard]] std::tuple<int, int> getFramebufferSize() const noexcept
+        {
+            return {_framebufferWidth, _framebufferHeight};
+        }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        [[nodiscard]] std::tuple<float, float> getContentScale() const noexcept
+        {
+            return {_xScale, _yScale};
+        }
+#endif
+
+        [[nodiscard]] std::tuple<double, double> getCursorPos() const noexcept
+        {
+            return {_cursorX, _cursorY};
+        }
+
+        [[nodiscard]] bool isFocused() const noexcept
+        {
+            return _focused;
+        }
+
+        [[nodiscard]] bool isIconified() const noexcept
+        {
+            return _iconified;
+        }
+
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+        [[nodiscard]] bool isMaximized() const noexcept
+        {
+            return _maximized;
+        }
+#endif
+
+        [[nodiscard]] bool isHovered() const noexcept
+        {
+            return _hovered;
+        }
+
+        [[nodiscard]] bool isVisible() const noexcept
+        {
+            return _visible;
+        }
+    };
+
     class Window
     {
     private:
@@ -456,6 +1191,9 @@ namespace glfw
 
             HandleContainer& operator=(HandleContainer&& other) noexcept
             {
+                _discardCoalesced(static_cast<GLFWwindow*>(*this));
+                _discardDeferred(static_cast<GLFWwindow*>(*this));
+                _discardStaleCallbacks(static_cast<GLFWwindow*>(*this));
                 glfwDestroyWindow(static_cast<GLFWwindow*>(*this));
                 static_cast<detail::OwningPtr<GLFWwindow>&>(*this) = std::move(other);
                 // NOTE: as above
@@ -467,10 +1205,57 @@ namespace glfw
 
             ~HandleContainer() noexcept
             {
+                _discardCoalesced(static_cast<GLFWwindow*>(*this));
+                _discardDeferred(static_cast<GLFWwindow*>(*this));
+                _discardStaleCallbacks(static_cast<GLFWwindow*>(*this));
                 glfwDestroyWindow(static_cast<GLFWwindow*>(*this));
             }
         } _handle;
         detail::OwningPtr<void> _userPtr;
+        detail::OwningPtr<EventQueue> _eventQueue;
+
+        struct CoalescingState
+        {
+            EventCoalescing policy;
+            CoalescingStats stats;
+            bool pending[5];
+            WindowEvent events[5];
+        };
+        std::unique_ptr<CoalescingState> _coalescing;
+        std::unique_ptr<InputState> _inputState;
+        detail::OwningPtr<MouseMotionAccumulator> _motionAccumulator;
+        std::unique_ptr<WindowState> _cachedState;
+        static inline std::vector<GLFWwindow*> _coalescedWindows;
+
+        static constexpr unsigned _deferredTitle = 1u << 0;
+        static constexpr unsigned _deferredOpacity = 1u << 1;
+        static constexpr unsigned _deferredSizeLimits = 1u << 2;
+        static constexpr unsigned _deferredSize = 1u << 3;
+        static constexpr unsigned _deferredPos = 1u << 4;
+
+        struct DeferredState
+        {
+            DeferredPropertyStats stats;
+            unsigned pending = 0;
+            unsigned known = 0;  // Properties whose applied value is known
+            std::string title, appliedTitle;
+            float opacity = 1, appliedOpacity = 1;
+            std::array<int, 4> sizeLimits{}, appliedSizeLimits{};
+            std::array<int, 2> size{}, appliedSize{};
+            std::array<int, 2> pos{}, appliedPos{};
+        };
+        std::unique_ptr<DeferredState> _deferred;
+        static inline std::vector<GLFWwindow*> _deferredWindows;
+
+        bool _lazyCallbacks = false;
+        std::uint32_t _staleCallbacks = 0;
+        // Set by BasicWindow, whose callbacks replace those of Window
+        bool _subclassCallbacks = false;
+        static inline std::vector<GLFWwindow*> _staleCallbackWindows;
+
+        friend class EventQueue;
+        template<typename HandlersT>
+        friend class BasicWindow;
 
     public:
         Event<Window&, int, int> posEvent;
@@ -486,65 +1271,584 @@ namespace glfw
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
         Event<Window&, float, float> contentScaleEvent;
 #endif
+        // Receives the record of every event of the window, before it is queued or dispatched
+        Event<const WindowEvent&> anyEvent;
+
+    private:
+        static Window& _getWrapperFromHandle(GLFWwindow* handle_)
+        {
+            return *static_cast<Window*>(glfwGetWindowUserPointer(handle_));
+        }
+        static void _setPointerFromHandle(GLFWwindow* handle_, Window* ptr_)
+        {
+            glfwSetWindowUserPointer(handle_, ptr_);
+        }
+
+        void _dispatch(const WindowEvent& event_)
+        {
+            detail::eventTimestamp = event_.timestamp;
+            switch(event_.type)
+            {
+                case WindowEventType::Pos:
+                    posEvent(*this, event_.pos.x, event_.pos.y);
+                    break;
+                case WindowEventType::Size:
+                    sizeEvent(*this, event_.size.width, event_.size.height);
+                    break;
+                case WindowEventType::Close:
+                    closeEvent(*this);
+                    break;
+                case WindowEventType::Refresh:
+                    refreshEvent(*this);
+                    break;
+                case WindowEventType::Focus:
+                    focusEvent(*this, event_.value);
+                    break;
+                case WindowEventType::Iconify:
+                    iconifyEvent(*this, event_.value);
+                    break;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::Maximize:
+                    maximizeEvent(*this, event_.value);
+                    break;
+#endif
+                case WindowEventType::FramebufferSize:
+                    framebufferSizeEvent(*this, event_.size.width, event_.size.height);
+                    break;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                case WindowEventType::ContentScale:
+                    contentScaleEvent(*this, event_.contentScale.x, event_.contentScale.y);
+                    break;
+#endif
+                case WindowEventType::Key:
+                    keyEvent(*this, event_.key.key, event_.key.scanCode, event_.key.state, event_.key.mods);
+                    break;
+                case WindowEventType::Char:
+                    charEvent(*this, event_.codePoint);
+                    break;
+                case WindowEventType::MouseButton:
+                    mouseButtonEvent(*this, event_.mouseButton.button, event_.mouseButton.state, event_.mouseButton.mods);
+                    break;
+                case WindowEventType::CursorPos:
+                    cursorPosEvent(*this, event_.cursorPos.x, event_.cursorPos.y);
+                    break;
+                case WindowEventType::CursorEnter:
+                    cursorEnterEvent(*this, event_.value);
+                    break;
+                case WindowEventType::Scroll:
+                    scrollEvent(*this, event_.scroll.x, event_.scroll.y);
+                    break;
+                case WindowEventType::Drop:
+                    dropPathsEvent(*this, PathsView{event_.drop.paths, static_cast<std::size_t>(event_.drop.count)});
+                    if(dropEvent.hasHandlers())
+                    {
+                        dropEvent(*this, {event_.drop.paths, event_.drop.paths + event_.drop.count});
+                    }
+                    break;
+            }
+        }
+
+        // Returns true if the event was merged and will be delivered at the end of the poll
+        bool _coalesce(const WindowEvent& event_)
+        {
+            if(!_coalescing)
+            {
+                return false;
+            }
+
+            std::size_t index;
+            switch(event_.type)
+            {
+                case WindowEventType::Pos:
+                    index = 0;
+                    break;
+                case WindowEventType::Size:
+                    index = 1;
+                    break;
+                case WindowEventType::FramebufferSize:
+                    index = 2;
+                    break;
+                case WindowEventType::CursorPos:
+                    index = 3;
+                    break;
+                case WindowEventType::Scroll:
+                    index = 4;
+                    break;
+                default:
+                    return false;
+            }
+
+            CoalescingState& state = *_coalescing;
+            const bool enabled[] = {state.policy.pos, state.policy.size, state.policy.framebufferSize, state.policy.cursorPos, state.policy.scroll};
+            std::uint64_t* const merged[] = {&state.stats.pos, &state.stats.size, &state.stats.framebufferSize, &state.stats.cursorPos, &state.stats.scroll};
+            if(!enabled[index])
+            {
+                return false;
+            }
+
+            WindowEvent& pending = state.events[index];
+            if(!state.pending[index])
+            {
+                pending = event_;
+                state.pending[index] = true;
+                if(std::find(_coalescedWindows.begin(), _coalescedWindows.end(), _handle) == _coalescedWindows.end())
+                {
+                    _coalescedWindows.push_back(_handle);
+                }
+            }
+            else if(event_.type == WindowEventType::Scroll)
+            {
+                pending.scroll.x += event_.scroll.x;
+                pending.scroll.y += event_.scroll.y;
+                pending.timestamp = event_.timestamp;
+                ++*merged[index];
+            }
+            else
+            {
+                pending = event_;
+                ++*merged[index];
+            }
+            return true;
+        }
+
+        static void _flushCoalesced(void*)
+        {
+            // Events caused by the handlers themselves are delivered at the next poll
+            const std::size_t count = _coalescedWindows.size();
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                GLFWwindow* handle = std::exchange(_coalescedWindows[i], nullptr);
+                if(!handle)
+                {
+                    continue;
+                }
+
+                Window& wrapper = _getWrapperFromHandle(handle);
+                CoalescingState& state = *wrapper._coalescing;
+                for(std::size_t j = 0; j < 5; ++j)
+                {
+                    if(state.pending[j])
+                    {
+                        state.pending[j] = false;
+                        WindowEvent event = state.events[j];
+                        event.window = &wrapper;
+                        if(!wrapper._forward(event))
+                        {
+                            wrapper._dispatch(event);
+                        }
+                    }
+                }
+            }
+            _coalescedWindows.erase(std::remove(_coalescedWindows.begin(), _coalescedWindows.end(), nullptr), _coalescedWindows.end());
+        }
+
+        static void _discardCoalesced(GLFWwindow* handle_) noexcept
+        {
+            if(handle_)
+            {
+                std::replace(_coalescedWindows.begin(), _coalescedWindows.end(), handle_, static_cast<GLFWwindow*>(nullptr));
+            }
+        }
+
+        // Stores a property change until the next flush
+        template<typename T, typename ValueT>
+        void _defer(unsigned property_, T& pending_, const ValueT& value_)
+        {
+            DeferredState& state = *_deferred;
+            if(state.pending & property_)
+            {
+                ++state.stats.skipped;
+            }
+            else if(!state.pending && std::find(_deferredWindows.begin(), _deferredWindows.end(), _handle) == _deferredWindows.end())
+            {
+                _deferredWindows.push_back(_handle);
+            }
+            state.pending |= property_;
+            pending_ = value_;
+        }
+
+        // Returns true if a pending change differs from the applied value and has to be passed to GLFW
+        template<typename T>
+        bool _takeDeferred(unsigned pending_, unsigned property_, T& applied_, const T& value_)
+        {
+            if(!(pending_ & property_))
+            {
+                return false;
+            }
+
+            DeferredState& state = *_deferred;
+            if((state.known & property_) && applied_ == value_)
+            {
+                ++state.stats.skipped;
+                return false;
+            }
+            applied_ = value_;
+            state.known |= property_;
+            ++state.stats.applied;
+            return true;
+        }
+
+        // Keeps the applied position and size in sync with moves and resizes by the user
+        void _trackDeferred(const WindowEvent& event_) noexcept
+        {
+            if(event_.type == WindowEventType::Pos)
+            {
+                _deferred->appliedPos = {event_.pos.x, event_.pos.y};
+                _deferred->known |= _deferredPos;
+            }
+            else
+            {
+                _deferred->appliedSize = {event_.size.width, event_.size.height};
+                _deferred->known |= _deferredSize;
+            }
+        }
+
+        static void _flushDeferred(void*)
+        {
+            // Changes made by handlers during the flush are applied at the next poll
+            const std::size_t count = _deferredWindows.size();
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                if(GLFWwindow* handle = std::exchange(_deferredWindows[i], nullptr))
+                {
+                    _getWrapperFromHandle(handle).flushProperties();
+                }
+            }
+            _deferredWindows.erase(std::remove(_deferredWindows.begin(), _deferredWindows.end(), nullptr), _deferredWindows.end());
+        }
+
+        static void _discardDeferred(GLFWwindow* handle_) noexcept
+        {
+            if(handle_)
+            {
+                std::replace(_deferredWindows.begin(), _deferredWindows.end(), handle_, static_cast<GLFWwindow*>(nullptr));
+            }
+        }
+
+        static constexpr std::uint32_t _callbackBit(WindowEventType type_) noexcept
+        {
+            return 1u << static_cast<unsigned>(type_);
+        }
+        static constexpr std::uint32_t _allCallbacks = ~0u;
+
+        template<std::uint32_t Callbacks>
+        static void _setEventHook(detail::EventBase& event_, GLFWwindow* handle_) noexcept
+        {
+            event_._setPresenceHook(handle_ ? &Window::_handlersChanged<Callbacks> : nullptr, handle_);
+        }
+
+        // Makes adding or removing a handler update the GLFW callbacks of the
+        // event. Passing nullptr detaches the events from the window.
+        void _setEventHooks(GLFWwindow* handle_) noexcept
+        {
+            _setEventHook<_callbackBit(WindowEventType::Pos)>(posEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Size)>(sizeEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Close)>(closeEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Refresh)>(refreshEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Focus)>(focusEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Iconify)>(iconifyEvent, handle_);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            _setEventHook<_callbackBit(WindowEventType::Maximize)>(maximizeEvent, handle_);
+#endif
+            _setEventHook<_callbackBit(WindowEventType::FramebufferSize)>(framebufferSizeEvent, handle_);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            _setEventHook<_callbackBit(WindowEventType::ContentScale)>(contentScaleEvent, handle_);
+#endif
+            _setEventHook<_allCallbacks>(anyEvent, handle_);
+
+            _setEventHook<_callbackBit(WindowEventType::Key)>(keyEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Char)>(charEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::MouseButton)>(mouseButtonEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::CursorPos)>(cursorPosEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::CursorEnter)>(cursorEnterEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Scroll)>(scrollEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Drop)>(dropEvent, handle_);
+            _setEventHook<_callbackBit(WindowEventType::Drop)>(dropPathsEvent, handle_);
+        }
+
+        template<std::uint32_t Callbacks>
+        static void _handlersChanged(void* handle_, bool deferred_)
+        {
+            Window& wrapper = _getWrapperFromHandle(static_cast<GLFWwindow*>(handle_));
+            if(deferred_)
+            {
+                wrapper._deferCallbackUpdate(Callbacks);
+            }
+            else
+            {
+                wrapper._updateCallbacks(Callbacks);
+            }
+        }
+
+        // Records callbacks to update at the next poll, for handler removals
+        // from noexcept paths, which must not call into GLFW. Until then a
+        // callback may stay installed without a handler, which is harmless.
+        void _deferCallbackUpdate(std::uint32_t callbacks_) noexcept
+        {
+            if(!_lazyCallbacks)
+            {
+                return;
+            }
+            if(!_staleCallbacks)
+            {
+                try
+                {
+                    _staleCallbackWindows.push_back(_handle);
+                }
+                catch(...)
+                {
+                    return;
+                }
+            }
+            _staleCallbacks |= callbacks_;
+        }
+
+        static void _flushStaleCallbacks(void*)
+        {
+            const std::size_t count = _staleCallbackWindows.size();
+            for(std::size_t i = 0; i < count; ++i)
+            {
+                if(GLFWwindow* handle = std::exchange(_staleCallbackWindows[i], nullptr))
+                {
+                    Window& wrapper = _getWrapperFromHandle(handle);
+                    wrapper._updateCallbacks(std::exchange(wrapper._staleCallbacks, 0u));
+                }
+            }
+            _staleCallbackWindows.erase(std::remove(_staleCallbackWindows.begin(), _staleCallbackWindows.end(), nullptr), _staleCallbackWindows.end());
+        }
+
+        static void _discardStaleCallbacks(GLFWwindow* handle_) noexcept
+        {
+            if(handle_)
+            {
+                std::replace(_staleCallbackWindows.begin(), _staleCallbackWindows.end(), handle_, static_cast<GLFWwindow*>(nullptr));
+            }
+        }
+
+        // Only lazily installed callbacks depend on the handlers and options
+        void _updateCallbacks(std::uint32_t callbacks_ = _allCallbacks)
+        {
+            if(_lazyCallbacks)
+            {
+                _setCallbacks(callbacks_);
+            }
+        }
+
+        // Sets or clears one GLFW callback. A callback that was replaced by
+        // other code (such as the GLFW backend of Dear ImGui) is put back,
+        // so it is never cleared or overwritten.
+        template<typename CallbackT>
+        void _setCallback(std::uint32_t callbacks_, WindowEventType type_, CallbackT (*setter_)(GLFWwindow*, CallbackT), CallbackT callback_, bool needed_)
+        {
+            if(!(callbacks_ & _callbackBit(type_)))
+            {
+                return;
+            }
+
+            const CallbackT previous = setter_(_handle, needed_ ? callback_ : nullptr);
+            if(previous && previous != callback_)
+            {
+                setter_(_handle, previous);
+            }
+        }
+
+        // Installs the selected GLFW callbacks. With lazy callbacks only
+        // those of events that have a handler are installed, or all of them
+        // while anyEvent has handlers or a queue is attached. The input
+        // callbacks are also needed while the input state is tracked or a
+        // motion accumulator is attached.
+        void _setCallbacks(std::uint32_t callbacks_)
+        {
+            if(!_handle || _subclassCallbacks)
+            {
+                return;
+            }
+
+            const bool all = !_lazyCallbacks || anyEvent.hasHandlers() || _eventQueue;
+            const bool tracking = static_cast<bool>(_inputState);
+            const bool accumulating = static_cast<bool>(_motionAccumulator);
+            const bool caching = static_cast<bool>(_cachedState);
+            const bool deferring = static_cast<bool>(_deferred);
+            _setCallback(callbacks_, WindowEventType::Pos, glfwSetWindowPosCallback, _posCallback, all || caching || deferring || posEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Size, glfwSetWindowSizeCallback, _sizeCallback, all || caching || deferring || sizeEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Close, glfwSetWindowCloseCallback, _closeCallback, all || closeEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Refresh, glfwSetWindowRefreshCallback, _refreshCallback, all || refreshEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Focus, glfwSetWindowFocusCallback, _focusCallback, all || caching || focusEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Iconify, glfwSetWindowIconifyCallback, _iconifyCallback, all || caching || iconifyEvent.hasHandlers());
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            _setCallback(callbacks_, WindowEventType::Maximize, glfwSetWindowMaximizeCallback, _maximizeCallback, all || caching || maximizeEvent.hasHandlers());
+#endif
+            _setCallback(callbacks_, WindowEventType::FramebufferSize, glfwSetFramebufferSizeCallback, _framebufferSizeCallback, all || caching || framebufferSizeEvent.hasHandlers());
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            _setCallback(callbacks_, WindowEventType::ContentScale, glfwSetWindowContentScaleCallback, _contentScaleCallback, all || caching || contentScaleEvent.hasHandlers());
+#endif
 
-    private:
-        static Window& _getWrapperFromHandle(GLFWwindow* handle_)
+            _setCallback(callbacks_, WindowEventType::Key, glfwSetKeyCallback, _keyCallback, all || tracking || keyEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Char, glfwSetCharCallback, _charCallback, all || charEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::MouseButton, glfwSetMouseButtonCallback, _mouseButtonCallback, all || tracking || mouseButtonEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::CursorPos, glfwSetCursorPosCallback, _cursorPosCallback, all || tracking || accumulating || caching || cursorPosEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::CursorEnter, glfwSetCursorEnterCallback, _cursorEnterCallback, all || caching || cursorEnterEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Scroll, glfwSetScrollCallback, _scrollCallback, all || tracking || scrollEvent.hasHandlers());
+            _setCallback(callbacks_, WindowEventType::Drop, glfwSetDropCallback, _dropCallback, all || dropEvent.hasHandlers() || dropPathsEvent.hasHandlers());
+        }
+
+        // The options below are implemented in the callbacks of Window
+        void _requireWindowCallbacks() const
         {
-            return *static_cast<Window*>(glfwGetWindowUserPointer(handle_));
+            if(_subclassCallbacks)
+            {
+                throw Error("Not supported by BasicWindow");
+            }
         }
-        static void _setPointerFromHandle(GLFWwindow* handle_, Window* ptr_)
+
+        // Returns true if the event was buffered and must not be dispatched now
+        bool _forward(const WindowEvent& event_)
         {
-            glfwSetWindowUserPointer(handle_, ptr_);
+            anyEvent(event_);
+            if(EventQueue* queue = _eventQueue)
+            {
+                queue->_push(event_);
+                return true;
+            }
+            return false;
         }
 
     private:
         static void _posCallback(GLFWwindow* window_, int xPos_, int yPos_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Pos));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.posEvent(wrapper, xPos_, yPos_);
+            WindowEvent event{&wrapper, WindowEventType::Pos, detail::stampEvent(), {}};
+            event.pos = {xPos_, yPos_};
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(wrapper._deferred)
+            {
+                wrapper._trackDeferred(event);
+            }
+            if(!wrapper._coalesce(event) && !wrapper._forward(event))
+            {
+                wrapper.posEvent(wrapper, xPos_, yPos_);
+            }
         }
         static void _sizeCallback(GLFWwindow* window_, int width_, int height_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Size));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.sizeEvent(wrapper, width_, height_);
+            WindowEvent event{&wrapper, WindowEventType::Size, detail::stampEvent(), {}};
+            event.size = {width_, height_};
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(wrapper._deferred)
+            {
+                wrapper._trackDeferred(event);
+            }
+            if(!wrapper._coalesce(event) && !wrapper._forward(event))
+            {
+                wrapper.sizeEvent(wrapper, width_, height_);
+            }
         }
         static void _closeCallback(GLFWwindow* window_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Close));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.closeEvent(wrapper);
+            WindowEvent event{&wrapper, WindowEventType::Close, detail::stampEvent(), {}};
+            if(!wrapper._forward(event))
+            {
+                wrapper.closeEvent(wrapper);
+            }
         }
         static void _refreshCallback(GLFWwindow* window_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Refresh));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.refreshEvent(wrapper);
+            WindowEvent event{&wrapper, WindowEventType::Refresh, detail::stampEvent(), {}};
+            if(!wrapper._forward(event))
+            {
+                wrapper.refreshEvent(wrapper);
+            }
         }
         static void _focusCallback(GLFWwindow* window_, int value_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Focus));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.focusEvent(wrapper, value_);
+            WindowEvent event{&wrapper, WindowEventType::Focus, detail::stampEvent(), {}};
+            event.value = value_;
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.focusEvent(wrapper, value_);
+            }
         }
         static void _iconifyCallback(GLFWwindow* window_, int value_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Iconify));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.iconifyEvent(wrapper, value_);
+            WindowEvent event{&wrapper, WindowEventType::Iconify, detail::stampEvent(), {}};
+            event.value = value_;
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.iconifyEvent(wrapper, value_);
+            }
         }
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
         static void _maximizeCallback(GLFWwindow* window_, int value_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Maximize));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.maximizeEvent(wrapper, value_);
+            WindowEvent event{&wrapper, WindowEventType::Maximize, detail::stampEvent(), {}};
+            event.value = value_;
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.maximizeEvent(wrapper, value_);
+            }
         }
 #endif
         static void _framebufferSizeCallback(GLFWwindow* window_, int width_, int height_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::FramebufferSize));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.framebufferSizeEvent(wrapper, width_, height_);
+            WindowEvent event{&wrapper, WindowEventType::FramebufferSize, detail::stampEvent(), {}};
+            event.size = {width_, height_};
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._coalesce(event) && !wrapper._forward(event))
+            {
+                wrapper.framebufferSizeEvent(wrapper, width_, height_);
+            }
         }
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
         static void _contentScaleCallback(GLFWwindow* window_, float xScale_, float yScale_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::ContentScale));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.contentScaleEvent(wrapper, xScale_, yScale_);
+            WindowEvent event{&wrapper, WindowEventType::ContentScale, detail::stampEvent(), {}};
+            event.contentScale = {xScale_, yScale_};
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.contentScaleEvent(wrapper, xScale_, yScale_);
+            }
         }
 #endif
 
@@ -556,40 +1860,121 @@ namespace glfw
         Event<Window&, bool> cursorEnterEvent;
         Event<Window&, double, double> scrollEvent;
         Event<Window&, std::vector<const char*>> dropEvent;
+        // Same as dropEvent, without copying the paths into a vector
+        Event<Window&, PathsView> dropPathsEvent;
 
     private:
         static void _keyCallback(GLFWwindow* window_, int key_, int scanCode_, int state_, int mods_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Key));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.keyEvent(wrapper, static_cast<KeyCode::EnumType>(key_), scanCode_, static_cast<KeyState>(state_), static_cast<ModifierKeyBit>(mods_));
+            WindowEvent event{&wrapper, WindowEventType::Key, detail::stampEvent(), {}};
+            event.key = {static_cast<KeyCode::EnumType>(key_), scanCode_, static_cast<KeyState>(state_), static_cast<ModifierKeyBit>(mods_)};
+            if(wrapper._inputState)
+            {
+                wrapper._inputState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.keyEvent(wrapper, static_cast<KeyCode::EnumType>(key_), scanCode_, static_cast<KeyState>(state_), static_cast<ModifierKeyBit>(mods_));
+            }
         }
         static void _charCallback(GLFWwindow* window_, unsigned int codePoint_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Char));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.charEvent(wrapper, codePoint_);
+            WindowEvent event{&wrapper, WindowEventType::Char, detail::stampEvent(), {}};
+            event.codePoint = codePoint_;
+            if(!wrapper._forward(event))
+            {
+                wrapper.charEvent(wrapper, codePoint_);
+            }
         }
         static void _mouseButtonCallback(GLFWwindow* window_, int button_, int state_, int mods_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::MouseButton));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.mouseButtonEvent(wrapper, static_cast<MouseButton>(button_), static_cast<MouseButtonState>(state_), static_cast<ModifierKeyBit>(mods_));
+            WindowEvent event{&wrapper, WindowEventType::MouseButton, detail::stampEvent(), {}};
+            event.mouseButton = {static_cast<MouseButton>(button_), static_cast<MouseButtonState>(state_), static_cast<ModifierKeyBit>(mods_)};
+            if(wrapper._inputState)
+            {
+                wrapper._inputState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.mouseButtonEvent(wrapper, static_cast<MouseButton>(button_), static_cast<MouseButtonState>(state_), static_cast<ModifierKeyBit>(mods_));
+            }
         }
         static void _cursorPosCallback(GLFWwindow* window_, double xPos_, double yPos_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::CursorPos));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.cursorPosEvent(wrapper, xPos_, yPos_);
+            WindowEvent event{&wrapper, WindowEventType::CursorPos, detail::stampEvent(), {}};
+            event.cursorPos = {xPos_, yPos_};
+            if(wrapper._inputState)
+            {
+                wrapper._inputState->_update(event);
+            }
+            if(MouseMotionAccumulator* accumulator = wrapper._motionAccumulator)
+            {
+                accumulator->_addPosition(xPos_, yPos_, event.timestamp ? event.timestamp : glfwGetTimerValue());
+            }
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._coalesce(event) && !wrapper._forward(event))
+            {
+                wrapper.cursorPosEvent(wrapper, xPos_, yPos_);
+            }
         }
         static void _cursorEnterCallback(GLFWwindow* window_, int value_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::CursorEnter));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.cursorEnterEvent(wrapper, static_cast<bool>(value_));
+            WindowEvent event{&wrapper, WindowEventType::CursorEnter, detail::stampEvent(), {}};
+            event.value = value_;
+            if(wrapper._cachedState)
+            {
+                wrapper._cachedState->_update(event);
+            }
+            if(!wrapper._forward(event))
+            {
+                wrapper.cursorEnterEvent(wrapper, static_cast<bool>(value_));
+            }
         }
         static void _scrollCallback(GLFWwindow* window_, double xOffset_, double yOffset_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Scroll));
             Window& wrapper = _getWrapperFromHandle(window_);
-            wrapper.scrollEvent(wrapper, xOffset_, yOffset_);
+            WindowEvent event{&wrapper, WindowEventType::Scroll, detail::stampEvent(), {}};
+            event.scroll = {xOffset_, yOffset_};
+            if(wrapper._inputState)
+            {
+                wrapper._inputState->_update(event);
+            }
+            if(!wrapper._coalesce(event) && !wrapper._forward(event))
+            {
+                wrapper.scrollEvent(wrapper, xOffset_, yOffset_);
+            }
         }
         static void _dropCallback(GLFWwindow* window_, int count_, const char** pPaths_)
         {
+            GLFWPP_PROFILE_CALLBACK(detail::profileSlot(WindowEventType::Drop));
+            Window& wrapper = _getWrapperFromHandle(window_);
+            WindowEvent event{&wrapper, WindowEventType::Drop, detail::stampEvent(), {}};
+            event.drop = {pPaths_, count_};
+            if(wrapper._forward(event))
+            {
+                return;
+            }
+
+            wrapper.dropPathsEvent(wrapper, PathsView{pPaths_, static_cast<std::size_t>(count_)});
+            if(!wrapper.dropEvent.hasHandlers())
+            {
+                return;
+            }
+
             std::vector<const char*> paths;
             paths.reserve(count_);
 
@@ -598,7 +1983,6 @@ namespace glfw
                 paths.emplace_back(pPaths_[i]);
             }
 
-            Window& wrapper = _getWrapperFromHandle(window_);
             wrapper.dropEvent(wrapper, paths);
         }
 
@@ -612,33 +1996,23 @@ namespace glfw
         //Takes ownership
         explicit Window(GLFWwindow* handle_) :
             _handle{handle_},
-            _userPtr{}
+            _userPtr{},
+            _eventQueue{},
+            _coalescing{},
+            _inputState{},
+            _motionAccumulator{},
+            _cachedState{},
+            _deferred{},
+            _lazyCallbacks{},
+            _staleCallbacks{},
+            _subclassCallbacks{}
         {
             if(_handle)
             {
                 _setPointerFromHandle(_handle, this);
 
-                glfwSetWindowPosCallback(_handle, _posCallback);
-                glfwSetWindowSizeCallback(_handle, _sizeCallback);
-                glfwSetWindowCloseCallback(_handle, _closeCallback);
-                glfwSetWindowRefreshCallback(_handle, _refreshCallback);
-                glfwSetWindowFocusCallback(_handle, _focusCallback);
-                glfwSetWindowIconifyCallback(_handle, _iconifyCallback);
-#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
-                glfwSetWindowMaximizeCallback(_handle, _maximizeCallback);
-#endif
-                glfwSetFramebufferSizeCallback(_handle, _framebufferSizeCallback);
-#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
-                glfwSetWindowContentScaleCallback(_handle, _contentScaleCallback);
-#endif
-
-                glfwSetKeyCallback(_handle, _keyCallback);
-                glfwSetCharCallback(_handle, _charCallback);
-                glfwSetMouseButtonCallback(_handle, _mouseButtonCallback);
-                glfwSetCursorPosCallback(_handle, _cursorPosCallback);
-                glfwSetCursorEnterCallback(_handle, _cursorEnterCallback);
-                glfwSetScrollCallback(_handle, _scrollCallback);
-                glfwSetDropCallback(_handle, _dropCallback);
+                _setEventHooks(_handle);
+                _setCallbacks(_allCallbacks);
             }
         }
 
@@ -684,6 +2058,11 @@ namespace glfw
 
         void setTitle(const char* title_)
         {
+            if(_deferred)
+            {
+                _defer(_deferredTitle, _deferred->title, title_);
+                return;
+            }
             glfwSetWindowTitle(_handle, title_);
         }
 
@@ -694,6 +2073,10 @@ namespace glfw
 
         [[nodiscard]] std::tuple<int, int> getPos() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->getPos();
+            }
             int xPos, yPos;
             glfwGetWindowPos(_handle, &xPos, &yPos);
             return {xPos, yPos};
@@ -701,11 +2084,20 @@ namespace glfw
 
         void setPos(int xPos_, int yPos_)
         {
+            if(_deferred)
+            {
+                _defer(_deferredPos, _deferred->pos, std::array<int, 2>{xPos_, yPos_});
+                return;
+            }
             glfwSetWindowPos(_handle, xPos_, yPos_);
         }
 
         [[nodiscard]] std::tuple<int, int> getSize() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->getSize();
+            }
             int width, height;
             glfwGetWindowSize(_handle, &width, &height);
             return {width, height};
@@ -713,6 +2105,11 @@ namespace glfw
 
         void setSizeLimits(int minWidth_, int minHeight_, int maxWidth_, int maxHeight_)
         {
+            if(_deferred)
+            {
+                _defer(_deferredSizeLimits, _deferred->sizeLimits, std::array<int, 4>{minWidth_, minHeight_, maxWidth_, maxHeight_});
+                return;
+            }
             glfwSetWindowSizeLimits(_handle, minWidth_, minHeight_, maxWidth_, maxHeight_);
         }
 
@@ -723,11 +2120,20 @@ namespace glfw
 
         void setSize(int width_, int height_)
         {
+            if(_deferred)
+            {
+                _defer(_deferredSize, _deferred->size, std::array<int, 2>{width_, height_});
+                return;
+            }
             glfwSetWindowSize(_handle, width_, height_);
         }
 
         [[nodiscard]] std::tuple<int, int> getFramebufferSize() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->getFramebufferSize();
+            }
             int width, height;
             glfwGetFramebufferSize(_handle, &width, &height);
             return {width, height};
@@ -736,6 +2142,10 @@ namespace glfw
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
         [[nodiscard]] std::tuple<float, float> getContentScale() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->getContentScale();
+            }
             float xScale, yScale;
             glfwGetWindowContentScale(_handle, &xScale, &yScale);
             return {xScale, yScale};
@@ -752,6 +2162,11 @@ namespace glfw
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
         void setOpacity(float opacity_)
         {
+            if(_deferred)
+            {
+                _defer(_deferredOpacity, _deferred->opacity, opacity_);
+                return;
+            }
             glfwSetWindowOpacity(_handle, opacity_);
         }
 #endif
@@ -774,11 +2189,19 @@ namespace glfw
         void show()
         {
             glfwShowWindow(_handle);
+            if(_cachedState)
+            {
+                _cachedState->_visible = true;
+            }
         }
 
         void hide()
         {
             glfwHideWindow(_handle);
+            if(_cachedState)
+            {
+                _cachedState->_visible = false;
+            }
         }
 
         void focus()
@@ -803,30 +2226,58 @@ namespace glfw
             glfwSetWindowMonitor(_handle, static_cast<GLFWmonitor*>(monitor_), xPos_, yPos_, width_, height_, refreshRate_);
         }
 
+        // Makes the window full screen on `monitor_` with the resolution and refresh rate of `mode_`
+        void setMonitor(Monitor monitor_, const VideoMode& mode_)
+        {
+            glfwSetWindowMonitor(_handle, static_cast<GLFWmonitor*>(monitor_), 0, 0, mode_.width, mode_.height, mode_.refreshRate);
+        }
+
         [[nodiscard]] bool getAttribFocused() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->isFocused();
+            }
             return glfwGetWindowAttrib(_handle, GLFW_FOCUSED);
         }
 
         [[nodiscard]] bool getAttribIconified() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->isIconified();
+            }
             return glfwGetWindowAttrib(_handle, GLFW_ICONIFIED);
         }
 
         [[nodiscard]] bool getAttribMaximized() const
         {
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            if(_cachedState)
+            {
+                return _cachedState->isMaximized();
+            }
+#endif
             return glfwGetWindowAttrib(_handle, GLFW_MAXIMIZED);
         }
 
 #if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
         [[nodiscard]] bool getAttribHovered() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->isHovered();
+            }
             return glfwGetWindowAttrib(_handle, GLFW_HOVERED);
         }
 #endif
 
         [[nodiscard]] bool getAttribVisible() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->isVisible();
+            }
             return glfwGetWindowAttrib(_handle, GLFW_VISIBLE);
         }
 
@@ -956,6 +2407,313 @@ namespace glfw
             return _userPtr;
         }
 
+        // By default all GLFW callbacks of the window stay installed. While
+        // enabled, only the callbacks of events that have a handler (or are
+        // needed by an enabled option) are installed, so events nobody
+        // listens to never reach C++. Callbacks replaced by other code are
+        // left alone either way.
+        void setLazyCallbacksEnabled(bool enabled_)
+        {
+            static detail::Hook<> flushHook{detail::pollBeginHooks, &Window::_flushStaleCallbacks, nullptr};
+            (void)flushHook;
+            _lazyCallbacks = enabled_;
+            _setCallbacks(_allCallbacks);
+        }
+
+        [[nodiscard]] bool getLazyCallbacksEnabled() const noexcept
+        {
+            return _lazyCallbacks;
+        }
+
+        // While a queue is set, events are buffered in it instead of being
+        // dispatched from inside pollEvents. Pass nullptr to go back to
+        // immediate dispatch. The queued events store the address of this
+        // object, so do not move or destroy it while the queue holds its
+        // events.
+        void setEventQueue(EventQueue* queue_)
+        {
+            if(queue_)
+            {
+                _requireWindowCallbacks();
+            }
+            _eventQueue = queue_;
+            _updateCallbacks();
+        }
+
+        [[nodiscard]] EventQueue* getEventQueue() const
+        {
+            return _eventQueue;
+        }
+
+        void setEventCoalescing(const EventCoalescing& coalescing_)
+        {
+            if(!_coalescing)
+            {
+                static detail::Hook<> flushHook{detail::pollEndHooks, &Window::_flushCoalesced, nullptr};
+                (void)flushHook;
+                _coalescing = std::make_unique<CoalescingState>();
+            }
+            _coalescing->policy = coalescing_;
+        }
+
+        [[nodiscard]] EventCoalescing getEventCoalescing() const
+        {
+            return _coalescing ? _coalescing->policy : EventCoalescing{};
+        }
+
+        [[nodiscard]] CoalescingStats getCoalescingStats() const
+        {
+            return _coalescing ? _coalescing->stats : CoalescingStats{};
+        }
+
+        void resetCoalescingStats()
+        {
+            if(_coalescing)
+            {
+                _coalescing->stats = {};
+            }
+        }
+
+        // While enabled, setTitle, setOpacity, setSizeLimits, setSize and
+        // setPos only record the new value. Recorded changes are applied
+        // on entry of the next pollEvents/waitEvents or by flushProperties,
+        // the last value of each property once and only if it differs from
+        // the value applied before. Getters return the applied values until
+        // then. Disabling flushes the pending changes.
+        void setDeferredPropertiesEnabled(bool enabled_)
+        {
+            if(!enabled_)
+            {
+                if(_deferred)
+                {
+                    flushProperties();
+                    _discardDeferred(_handle);
+                    _deferred.reset();
+                }
+            }
+            else if(!_deferred)
+            {
+                _requireWindowCallbacks();
+                static detail::Hook<> flushHook{detail::pollBeginHooks, &Window::_flushDeferred, nullptr};
+                (void)flushHook;
+                _deferred = std::make_unique<DeferredState>();
+                if(_handle)
+                {
+                    glfwGetWindowPos(_handle, &_deferred->appliedPos[0], &_deferred->appliedPos[1]);
+                    glfwGetWindowSize(_handle, &_deferred->appliedSize[0], &_deferred->appliedSize[1]);
+                    _deferred->known = _deferredPos | _deferredSize;
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+                    _deferred->appliedOpacity = glfwGetWindowOpacity(_handle);
+                    _deferred->known |= _deferredOpacity;
+#endif
+                }
+            }
+            _updateCallbacks();
+        }
+
+        [[nodiscard]] bool getDeferredPropertiesEnabled() const noexcept
+        {
+            return static_cast<bool>(_deferred);
+        }
+
+        // Applies the pending property changes now
+        void flushProperties()
+        {
+            if(!_deferred)
+            {
+                return;
+            }
+
+            DeferredState& state = *_deferred;
+            const unsigned pending = std::exchange(state.pending, 0u);
+            if(_takeDeferred(pending, _deferredSizeLimits, state.appliedSizeLimits, state.sizeLimits))
+            {
+                glfwSetWindowSizeLimits(_handle, state.sizeLimits[0], state.sizeLimits[1], state.sizeLimits[2], state.sizeLimits[3]);
+            }
+            if(_takeDeferred(pending, _deferredSize, state.appliedSize, state.size))
+            {
+                glfwSetWindowSize(_handle, state.size[0], state.size[1]);
+            }
+            if(_takeDeferred(pending, _deferredPos, state.appliedPos, state.pos))
+            {
+                glfwSetWindowPos(_handle, state.pos[0], state.pos[1]);
+            }
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            if(_takeDeferred(pending, _deferredOpacity, state.appliedOpacity, state.opacity))
+            {
+                glfwSetWindowOpacity(_handle, state.opacity);
+            }
+#endif
+            if(_takeDeferred(pending, _deferredTitle, state.appliedTitle, state.title))
+            {
+                glfwSetWindowTitle(_handle, state.title.c_str());
+            }
+        }
+
+        [[nodiscard]] DeferredPropertyStats getDeferredPropertyStats() const
+        {
+            return _deferred ? _deferred->stats : DeferredPropertyStats{};
+        }
+
+        void resetDeferredPropertyStats()
+        {
+            if(_deferred)
+            {
+                _deferred->stats = {};
+            }
+        }
+
+        // Starts or stops keeping an InputState for this window. When enabled,
+        // the state is initialized from the current keyboard and mouse state.
+        void setInputStateEnabled(bool enabled_)
+        {
+            if(!enabled_)
+            {
+                _inputState.reset();
+            }
+            else if(!_inputState)
+            {
+                _requireWindowCallbacks();
+                _inputState = std::make_unique<InputState>();
+                if(_handle)
+                {
+                    for(int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; ++key)
+                    {
+                        _inputState->_down.set(static_cast<std::size_t>(key), glfwGetKey(_handle, key) == GLFW_PRESS);
+                    }
+                    for(int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; ++button)
+                    {
+                        _inputState->_down.set(InputBits::keyCount + static_cast<std::size_t>(button), glfwGetMouseButton(_handle, button) == GLFW_PRESS);
+                    }
+                    glfwGetCursorPos(_handle, &_inputState->_cursorX, &_inputState->_cursorY);
+                }
+                _inputState->_previousDown = _inputState->_down;
+            }
+            _updateCallbacks();
+        }
+
+        // While an accumulator is set, every cursor position sample of this
+        // window is added to it. The accumulator starts from the current
+        // cursor position. Pass nullptr to detach it.
+        void setMouseMotionAccumulator(MouseMotionAccumulator* accumulator_)
+        {
+            if(accumulator_)
+            {
+                _requireWindowCallbacks();
+            }
+            _motionAccumulator = accumulator_;
+            if(accumulator_ && _handle)
+            {
+                double xPos, yPos;
+                glfwGetCursorPos(_handle, &xPos, &yPos);
+                accumulator_->_setPosition(xPos, yPos);
+            }
+            _updateCallbacks();
+        }
+
+        [[nodiscard]] MouseMotionAccumulator* getMouseMotionAccumulator() const
+        {
+            return _motionAccumulator;
+        }
+
+        // nullptr unless enabled with setInputStateEnabled
+        [[nodiscard]] InputState* getInputState() noexcept
+        {
+            return _inputState.get();
+        }
+        [[nodiscard]] const InputState* getInputState() const noexcept
+        {
+            return _inputState.get();
+        }
+
+        // While enabled, the position, size, framebuffer size, content
+        // scale, cursor position and the focused, iconified, maximized,
+        // hovered and visible attributes are kept up to date from the window
+        // callbacks, and the matching getters return them without a round
+        // trip to the display server. The cache is seeded with a live query.
+        // Content scale and maximized are only cached with GLFW 3.3, which
+        // has callbacks for them.
+        void setStateCachingEnabled(bool enabled_)
+        {
+            if(!enabled_)
+            {
+                _cachedState.reset();
+            }
+            else if(!_cachedState)
+            {
+                _requireWindowCallbacks();
+                _cachedState = std::make_unique<WindowState>();
+                refreshCachedState();
+            }
+            _updateCallbacks();
+        }
+
+        [[nodiscard]] bool getStateCachingEnabled() const noexcept
+        {
+            return static_cast<bool>(_cachedState);
+        }
+
+        // Reloads the cached state from GLFW, e.g. after changes GLFW has no
+        // callback for. Does nothing unless caching is enabled.
+        void refreshCachedState()
+        {
+            if(!_cachedState || !_handle)
+            {
+                return;
+            }
+
+            WindowState& state = *_cachedState;
+            glfwGetWindowPos(_handle, &state._xPos, &state._yPos);
+            glfwGetWindowSize(_handle, &state._width, &state._height);
+            glfwGetFramebufferSize(_handle, &state._framebufferWidth, &state._framebufferHeight);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            glfwGetWindowContentScale(_handle, &state._xScale, &state._yScale);
+#endif
+            glfwGetCursorPos(_handle, &state._cursorX, &state._cursorY);
+            state._focused = glfwGetWindowAttrib(_handle, GLFW_FOCUSED);
+            state._iconified = glfwGetWindowAttrib(_handle, GLFW_ICONIFIED);
+#if GLFW_VERSION_MAJOR >= 3 && GLFW_VERSION_MINOR >= 3
+            state._maximized = glfwGetWindowAttrib(_handle, GLFW_MAXIMIZED);
+            state._hovered = glfwGetWindowAttrib(_handle, GLFW_HOVERED);
+#endif
+            state._visible = glfwGetWindowAttrib(_handle, GLFW_VISIBLE);
+        }
+
+        // nullptr unless enabled with setStateCachingEnabled
+        [[nodiscard]] WindowState* getCachedState() noexcept
+        {
+            return _cachedState.get();
+        }
+        [[nodiscard]] const WindowState* getCachedState() const noexcept
+        {
+            return _cachedState.get();
+        }
+
+        // Delivers `event_` as if GLFW had reported it for this window: it is
+        // passed to anyEvent and then queued or dispatched. It is not
+        // coalesced. Works without an underlying GLFW window.
+        void injectEvent(const WindowEvent& event_)
+        {
+            WindowEvent event = event_;
+            event.window = this;
+            if(_inputState)
+            {
+                _inputState->_update(event);
+            }
+            if(MouseMotionAccumulator* accumulator = _motionAccumulator; accumulator && event.type == WindowEventType::CursorPos)
+            {
+                accumulator->_addPosition(event.cursorPos.x, event.cursorPos.y, event.timestamp);
+            }
+            if(_cachedState)
+            {
+                _cachedState->_update(event);
+            }
+            if(!_forward(event))
+            {
+                _dispatch(event);
+            }
+        }
+
         void swapBuffers()
         {
             glfwSwapBuffers(_handle);
@@ -1033,6 +2791,10 @@ namespace glfw
 
         [[nodiscard]] std::tuple<double, double> getCursorPos() const
         {
+            if(_cachedState)
+            {
+                return _cachedState->getCursorPos();
+            }
             double xPos, yPos;
             glfwGetCursorPos(_handle, &xPos, &yPos);
             return {xPos, yPos};
@@ -1040,6 +2802,11 @@ namespace glfw
         void setCursorPos(double xPos_, double yPos_)
         {
             glfwSetCursorPos(_handle, xPos_, yPos_);
+            if(_cachedState)
+            {
+                _cachedState->_cursorX = xPos_;
+                _cachedState->_cursorY = yPos_;
+            }
         }
 
         void setCursor(const Cursor& cursor_)
@@ -1084,9 +2851,12 @@ namespace glfw
     inline void makeContextCurrent(const Window& window_);
     [[nodiscard]] inline Window& getCurrentContext();
 
-    inline void swapInterval(int interval_)
+    inline void EventQueue::dispatch() const
     {
-        glfwSwapInterval(interval_);
+        for(const WindowEvent& event : *this)
+        {
+            event.window->_dispatch(event);
+        }
     }
 }  // namespace glfw
 
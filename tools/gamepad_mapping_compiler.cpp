@@ -0,0 +1,36 @@
+#include <fstream>
+#include <glfwpp/gamepad_mappings.h>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+// Usage: glfwpp_gamepad_mapping_compiler <gamecontrollerdb.txt> <output.bin>
+int main(int argc, char** argv)
+{
+    if(argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <mappings.txt> <output.bin>\n";
+        return 1;
+    }
+
+    std::ifstream input{argv[1], std::ios::binary};
+    if(!input)
+    {
+        std::cerr << "Could not open " << argv[1] << '\n';
+        return 1;
+    }
+    const std::string text{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+
+    std::ofstream output{argv[2], std::ios::binary | std::ios::trunc};
+    try
+    {
+        const std::size_t count = glfw::compileGamepadMappings(text, output);
+        std::cout << "Compiled " << count << " gamepad mappings into " << argv[2] << '\n';
+    }
+    catch(const glfw::Error& error_)
+    {
+        std::cerr << error_.what() << '\n';
+        return 1;
+    }
+    return 0;
+}